@@ -0,0 +1,333 @@
+/**
+ * @file    GraphGenerator.cpp
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * The implementation of the graph generator defined in GraphGenerator.h.
+ */
+#include "GraphGenerator.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+using namespace std;
+
+const char* const FAMILY_NAMES[FAMILY_COUNT] = { "grid", "layered", "clustered", "ports", "hubs" };
+
+const char* const SIDE_NAMES[] = { "NORTH", "EAST", "SOUTH", "WEST" };
+
+/** Distance of a port center from the border of its node. */
+const double PORT_OFFSET = 2.5;
+
+/** Id of the first port; smaller ids are reserved for the pins of port-less edges. */
+const unsigned int FIRST_PORT_ID = 5;
+
+namespace {
+
+struct Node {
+    double x;
+    double y;
+    double width;
+    double height;
+    int incoming;
+    int outgoing;
+};
+
+struct Port {
+    unsigned int node;
+    int side;
+    /** position of the center along the side, relative to the node. */
+    double offset;
+};
+
+struct Edge {
+    unsigned int source;
+    unsigned int target;
+    /** ids of the ports, 0 for none. */
+    unsigned int sourcePort;
+    unsigned int targetPort;
+};
+
+/**
+ * A graph under construction; ids of nodes are 1-based indices, ids of ports
+ * start at FIRST_PORT_ID.
+ */
+class Graph {
+public:
+    unsigned int addNode(double x, double y, double width, double height) {
+        Node node = { x, y, width, height, 0, 0 };
+        mNodes.push_back(node);
+        return mNodes.size();
+    }
+
+    unsigned int addPort(unsigned int node, int side, double offset) {
+        Port port = { node, side, offset };
+        mPorts.push_back(port);
+        return mPorts.size() - 1 + FIRST_PORT_ID;
+    }
+
+    void addCluster(double x1, double y1, double x2, double y2) {
+        double bounds[] = { x1, y1, x2, y2 };
+        mClusters.push_back(vector<double>(bounds, bounds + 4));
+    }
+
+    void addEdge(unsigned int source, unsigned int target, unsigned int sourcePort = 0,
+            unsigned int targetPort = 0) {
+        Edge edge = { source, target, sourcePort, targetPort };
+        mEdges.push_back(edge);
+        if (sourcePort == 0) {
+            ++mNodes[source - 1].outgoing;
+        }
+        if (targetPort == 0) {
+            ++mNodes[target - 1].incoming;
+        }
+    }
+
+    unsigned int elements() const {
+        return mNodes.size() + mPorts.size() + mClusters.size() + mEdges.size();
+    }
+
+    string write(bool stats, const string& options) const {
+        ostringstream out;
+        if (stats) {
+            out << "STATS\n";
+        }
+        out << "OPTION edgeRouting ORTHOGONAL\n";
+        out << options;
+        out << "GRAPH " << mNodes.size() << " " << mEdges.size() << " " << mPorts.size() << "\n";
+        for (size_t i = 0; i < mNodes.size(); ++i) {
+            const Node& node = mNodes[i];
+            out << "NODE " << i + 1 << " " << node.x << " " << node.y << " "
+                    << node.x + node.width << " " << node.y + node.height << " "
+                    << node.incoming << " " << node.outgoing << "\n";
+        }
+        // clusters continue the ids of the nodes
+        for (size_t i = 0; i < mClusters.size(); ++i) {
+            const vector<double>& c = mClusters[i];
+            out << "CLUSTER " << mNodes.size() + i + 1 << " " << c[0] << " " << c[1] << " "
+                    << c[2] << " " << c[3] << "\n";
+        }
+        for (size_t i = 0; i < mPorts.size(); ++i) {
+            const Port& port = mPorts[i];
+            const Node& node = mNodes[port.node - 1];
+            double x = port.offset;
+            double y = port.offset;
+            switch (port.side) {
+            case 0:
+                y = -PORT_OFFSET;
+                break;
+            case 1:
+                x = node.width + PORT_OFFSET;
+                break;
+            case 2:
+                y = node.height + PORT_OFFSET;
+                break;
+            default:
+                x = -PORT_OFFSET;
+                break;
+            }
+            out << "PORT " << i + FIRST_PORT_ID << " " << port.node << " " << SIDE_NAMES[port.side]
+                    << " " << x << " " << y << "\n";
+        }
+        for (size_t i = 0; i < mEdges.size(); ++i) {
+            const Edge& edge = mEdges[i];
+            const char* type = edge.sourcePort != 0
+                    ? (edge.targetPort != 0 ? "PEDGEP" : "PEDGE")
+                    : (edge.targetPort != 0 ? "EDGEP" : "EDGE");
+            out << type << " " << i + 1 << " " << edge.source << " " << edge.target << " "
+                    << edge.sourcePort << " " << edge.targetPort << "\n";
+        }
+        out << "GRAPHEND\n";
+        return out.str();
+    }
+
+private:
+    vector<Node> mNodes;
+    vector<Port> mPorts;
+    vector<vector<double> > mClusters;
+    vector<Edge> mEdges;
+};
+
+/** about 3 elements per node: the node and two edges */
+void generateGrid(Graph& graph, unsigned int elements) {
+    unsigned int n = max(2u, (unsigned int) sqrt(elements / 3.0));
+    for (unsigned int row = 0; row < n; ++row) {
+        for (unsigned int col = 0; col < n; ++col) {
+            graph.addNode(col * 80.0, row * 60.0, 40, 30);
+        }
+    }
+    for (unsigned int row = 0; row < n; ++row) {
+        for (unsigned int col = 0; col < n; ++col) {
+            unsigned int id = row * n + col + 1;
+            if (col + 1 < n) {
+                graph.addEdge(id, id + 1);
+            }
+            if (row + 1 < n) {
+                graph.addEdge(id, id + n);
+            }
+        }
+    }
+}
+
+/** about 3 elements per node: the node and two outgoing edges */
+void generateLayered(Graph& graph, unsigned int elements, mt19937& random) {
+    unsigned int nodes = max(4u, elements / 3);
+    unsigned int width = max(2u, (unsigned int) sqrt(nodes / 2.0));
+    unsigned int layers = max(2u, nodes / width);
+    for (unsigned int layer = 0; layer < layers; ++layer) {
+        for (unsigned int i = 0; i < width; ++i) {
+            graph.addNode(layer * 150.0, i * 60.0, 40, 30);
+        }
+    }
+    uniform_int_distribution<unsigned int> next(0, width - 1);
+    for (unsigned int layer = 0; layer + 1 < layers; ++layer) {
+        for (unsigned int i = 0; i < width; ++i) {
+            unsigned int id = layer * width + i + 1;
+            graph.addEdge(id, (layer + 1) * width + next(random) + 1);
+            graph.addEdge(id, (layer + 1) * width + next(random) + 1);
+        }
+    }
+}
+
+/** about 42 elements per group: 10 nodes, a cluster and 31 edges */
+void generateClustered(Graph& graph, unsigned int elements, mt19937& random) {
+    const unsigned int groupSize = 10;
+    const unsigned int columns = 5;
+    unsigned int groups = max(2u, elements / 42);
+    unsigned int groupColumns = max(1u, (unsigned int) sqrt((double) groups));
+    uniform_int_distribution<unsigned int> member(0, groupSize - 1);
+
+    for (unsigned int group = 0; group < groups; ++group) {
+        double x = (group % groupColumns) * 500.0;
+        double y = (group / groupColumns) * 300.0;
+        for (unsigned int i = 0; i < groupSize; ++i) {
+            graph.addNode(x + 20 + (i % columns) * 90.0, y + 20 + (i / columns) * 110.0, 40, 30);
+        }
+        graph.addCluster(x, y, x + 460, y + 260);
+
+        unsigned int first = group * groupSize + 1;
+        for (unsigned int i = 0; i < groupSize * 3; ++i) {
+            unsigned int source = member(random);
+            unsigned int target = member(random);
+            if (source == target) {
+                target = (target + 1) % groupSize;
+            }
+            graph.addEdge(first + source, first + target);
+        }
+        if (group > 0) {
+            graph.addEdge(first - groupSize + member(random), first + member(random));
+        }
+    }
+}
+
+/** about 7 elements per node: the node, four ports and two edges */
+void generatePorts(Graph& graph, unsigned int elements, mt19937& random) {
+    unsigned int nodes = max(4u, elements / 7);
+    unsigned int height = max(2u, (unsigned int) sqrt((double) nodes));
+    unsigned int columns = max(2u, nodes / height);
+    vector<unsigned int> eastPorts;
+    vector<unsigned int> westPorts;
+    for (unsigned int col = 0; col < columns; ++col) {
+        for (unsigned int row = 0; row < height; ++row) {
+            unsigned int node = graph.addNode(col * 160.0, row * 80.0, 40, 40);
+            eastPorts.push_back(graph.addPort(node, 1, 12));
+            eastPorts.push_back(graph.addPort(node, 1, 28));
+            westPorts.push_back(graph.addPort(node, 3, 12));
+            westPorts.push_back(graph.addPort(node, 3, 28));
+        }
+    }
+    uniform_int_distribution<unsigned int> next(0, height * 2 - 1);
+    for (unsigned int col = 0; col + 1 < columns; ++col) {
+        for (unsigned int i = 0; i < height * 2; ++i) {
+            unsigned int sourcePort = eastPorts[col * height * 2 + i];
+            unsigned int targetPort = westPorts[(col + 1) * height * 2 + next(random)];
+            // ports are created in pairs, so the node follows from the port id
+            graph.addEdge((sourcePort - FIRST_PORT_ID) / 4 + 1,
+                    (targetPort - FIRST_PORT_ID) / 4 + 1, sourcePort, targetPort);
+        }
+    }
+}
+
+/** about 81 elements per hub: the hub and 40 nodes with an edge each */
+void generateHubs(Graph& graph, unsigned int elements, mt19937& random) {
+    const unsigned int spokes = 40;
+    const double radius = 300;
+    unsigned int hubs = max(1u, elements / (2 * spokes + 1));
+    unsigned int columns = max(1u, (unsigned int) sqrt((double) hubs));
+    uniform_real_distribution<double> jitter(-0.05, 0.05);
+
+    for (unsigned int h = 0; h < hubs; ++h) {
+        double x = (h % columns) * (2 * radius + 200);
+        double y = (h / columns) * (2 * radius + 200);
+        unsigned int hub = graph.addNode(x - 30, y - 20, 60, 40);
+        for (unsigned int i = 0; i < spokes; ++i) {
+            double angle = (i + jitter(random)) * 2 * M_PI / spokes;
+            double nx = x + radius * cos(angle);
+            double ny = y + radius * sin(angle);
+            unsigned int node = graph.addNode(nx - 15, ny - 10, 30, 20);
+            // half of the edges point to the hub
+            if (i % 2 == 0) {
+                graph.addEdge(hub, node);
+            } else {
+                graph.addEdge(node, hub);
+            }
+        }
+    }
+}
+
+}
+
+const char* familyName(GraphFamily family) {
+    return FAMILY_NAMES[family];
+}
+
+bool parseFamily(const char* name, GraphFamily& family) {
+    for (int i = 0; i < FAMILY_COUNT; ++i) {
+        if (strcmp(name, FAMILY_NAMES[i]) == 0) {
+            family = (GraphFamily) i;
+            return true;
+        }
+    }
+    return false;
+}
+
+string generateRequest(GraphFamily family, unsigned int elements, unsigned int seed, bool stats,
+        const string& options, unsigned int& actualElements) {
+    mt19937 random(seed);
+    Graph graph;
+    switch (family) {
+    case FAMILY_GRID:
+        generateGrid(graph, elements);
+        break;
+    case FAMILY_LAYERED:
+        generateLayered(graph, elements, random);
+        break;
+    case FAMILY_CLUSTERED:
+        generateClustered(graph, elements, random);
+        break;
+    case FAMILY_PORTS:
+        generatePorts(graph, elements, random);
+        break;
+    default:
+        generateHubs(graph, elements, random);
+        break;
+    }
+    actualElements = graph.elements();
+    return graph.write(stats, options);
+}
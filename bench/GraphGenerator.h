@@ -0,0 +1,75 @@
+/**
+ * @file    GraphGenerator.h
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * Generator of synthetic routing requests in the server's text protocol. The
+ * graphs are deterministic for a given family, size and seed, so that
+ * results of different builds can be compared.
+ *
+ * Families:
+ *  - grid: nodes in a square grid, edges to the right and lower neighbours
+ *  - layered: a layered DAG with two edges from each node to the next layer
+ *  - clustered: groups of densely connected nodes, each within a cluster
+ *  - ports: nodes with two ports on the east and west side each, connected
+ *           by port-to-port edges
+ *  - hubs: hub nodes with many port-less edges to the nodes around them
+ */
+#ifndef __GRAPHGENERATOR_H__INCLUDED__
+#define __GRAPHGENERATOR_H__INCLUDED__
+
+#include <string>
+
+enum GraphFamily {
+    FAMILY_GRID,
+    FAMILY_LAYERED,
+    FAMILY_CLUSTERED,
+    FAMILY_PORTS,
+    FAMILY_HUBS,
+    FAMILY_COUNT
+};
+
+/**
+ * @return the name of a family as used on the command line
+ */
+const char* familyName(GraphFamily family);
+
+/**
+ * Looks up a family by its name.
+ *
+ * @return false if there is no such family
+ */
+bool parseFamily(const char* name, GraphFamily& family);
+
+/**
+ * Generates a request.
+ *
+ * @param family
+ *            the kind of graph
+ * @param elements
+ *            the approximate number of nodes, ports, clusters and edges
+ * @param seed
+ *            the seed of the random choices
+ * @param stats
+ *            should the request ask for STATS?
+ * @param options
+ *            OPTION lines added to the request, each terminated by a line break
+ * @param actualElements
+ *            set to the exact number of elements generated
+ * @return the text of the request, without chunk delimiter
+ */
+std::string generateRequest(GraphFamily family, unsigned int elements, unsigned int seed,
+        bool stats, const std::string& options, unsigned int& actualElements);
+
+#endif
@@ -0,0 +1,167 @@
+/**
+ * @file    ParseBenchmark.cpp
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * Parse-only microbenchmark comparing the LineParser with the former
+ * istringstream based tokenizer and number conversion. No router is involved.
+ *
+ * Usage: parse-benchmark [{edges}]
+ */
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <iterator>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+#include "LineParser.h"
+
+using namespace std;
+
+namespace legacy {
+
+void tokenize(std::string text, std::vector<std::string>& tokens) {
+    istringstream iss(text);
+    copy(istream_iterator<string>(iss), istream_iterator<string>(),
+            back_inserter<vector<string> >(tokens));
+}
+
+double toDouble(std::string const& s) {
+    std::istringstream i(s);
+    double x;
+    i >> x;
+    return x;
+}
+
+int toInt(std::string const& s) {
+    std::istringstream i(s);
+    int x;
+    i >> x;
+    return x;
+}
+
+}
+
+/**
+ * Creates the text of a graph with one node per edge and edges between
+ * consecutive nodes.
+ */
+static string createInput(int edges) {
+    ostringstream out;
+    out << "GRAPH\n";
+    for (int i = 1; i <= edges + 1; ++i) {
+        double x = (i % 100) * 60.5;
+        double y = (i / 100) * 45.25;
+        out << "NODE " << i << " " << x << " " << y << " " << x + 30 << " " << y + 20.75 << " 1 1\n";
+        out << "PORT " << i + 4 << " " << i << " EAST 32.5 12.5\n";
+    }
+    for (int i = 1; i <= edges; ++i) {
+        out << "PEDGEP " << i << " " << i << " " << i + 1 << " " << i + 4 << " " << i + 5 << "\n";
+    }
+    out << "GRAPHEND\n";
+    return out.str();
+}
+
+static double runLegacy(const string& input, double& checksum) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    istringstream in(input);
+    for (string line; getline(in, line);) {
+        vector<string> tokens;
+        legacy::tokenize(line, tokens);
+        if (tokens.empty()) {
+            continue;
+        }
+        if (tokens[0] == "NODE") {
+            checksum += legacy::toInt(tokens[1]) + legacy::toDouble(tokens[2]) + legacy::toDouble(tokens[3])
+                    + legacy::toDouble(tokens[4]) + legacy::toDouble(tokens[5]) + legacy::toInt(tokens[6])
+                    + legacy::toInt(tokens[7]);
+        } else if (tokens[0] == "PORT") {
+            checksum += legacy::toInt(tokens[1]) + legacy::toInt(tokens[2])
+                    + legacy::toDouble(tokens[4]) + legacy::toDouble(tokens[5]);
+        } else if (tokens[0] == "EDGE" || tokens[0] == "PEDGEP" || tokens[0] == "PEDGE"
+                || tokens[0] == "EDGEP") {
+            checksum += legacy::toInt(tokens[1]) + legacy::toInt(tokens[2]) + legacy::toInt(tokens[3])
+                    + legacy::toInt(tokens[4]) + legacy::toInt(tokens[5]);
+        }
+    }
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+static double runLineParser(const string& input, double& checksum) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    istringstream in(input);
+    string line;
+    LineParser tokens;
+    NodeRecord node;
+    PortRecord port;
+    EdgeRecord edge;
+    while (getline(in, line)) {
+        tokens.parse(line);
+        switch (tokens.command()) {
+        case CMD_NODE:
+            if (parseNode(tokens, node)) {
+                checksum += node.id + node.x1 + node.y1 + node.x2 + node.y2 + node.incoming + node.outgoing;
+            }
+            break;
+        case CMD_PORT:
+            if (parsePort(tokens, port)) {
+                checksum += port.id + port.node + port.x + port.y;
+            }
+            break;
+        case CMD_EDGE:
+        case CMD_PEDGEP:
+        case CMD_PEDGE:
+        case CMD_EDGEP:
+            if (parseEdge(tokens, edge)) {
+                checksum += edge.id + edge.source + edge.target + edge.sourcePort + edge.targetPort;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    int edges = argc > 1 ? atoi(argv[1]) : 50000;
+    const int runs = 5;
+    string input = createInput(edges);
+    size_t lines = std::count(input.begin(), input.end(), '\n');
+
+    double legacyBest = 0;
+    double parserBest = 0;
+    double legacyChecksum = 0;
+    double parserChecksum = 0;
+    for (int i = 0; i < runs; ++i) {
+        double legacy = runLegacy(input, legacyChecksum);
+        double parser = runLineParser(input, parserChecksum);
+        legacyBest = i == 0 ? legacy : min(legacyBest, legacy);
+        parserBest = i == 0 ? parser : min(parserBest, parser);
+    }
+
+    if (legacyChecksum != parserChecksum) {
+        cerr << "ERROR: parsers disagree (" << legacyChecksum << " vs. " << parserChecksum << ")" << endl;
+        return 1;
+    }
+
+    cout << "lines " << lines << endl;
+    cout << "istringstream " << legacyBest << " ms, " << legacyBest * 1e6 / lines << " ns/line" << endl;
+    cout << "LineParser " << parserBest << " ms, " << parserBest * 1e6 / lines << " ns/line" << endl;
+    cout << "speedup " << legacyBest / parserBest << endl;
+    return 0;
+}
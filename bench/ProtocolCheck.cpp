@@ -0,0 +1,538 @@
+/**
+ * @file    ProtocolCheck.cpp
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * Conformance check of the binary protocol against the text protocol. The
+ * generated requests of each family and size are sent to a server process once
+ * as text and once as BINARY frames, with NODE, PORT, EDGE and CLUSTER lines
+ * encoded as records. Both responses are decoded and compared: the routes of
+ * the edges, bit for bit, their ROUTE states and the HYPEREDGE lines. Each
+ * request is sent with a few layout options that change the response, see
+ * VARIANTS. None of the families has edges that share their source port, so
+ * the hyperedges are checked with NET_REQUEST.
+ *
+ * Usage:
+ *   protocol-check {server} [--families {f,...}] [--sizes {n,...}]
+ *                  [--arg {server argument}]...
+ *
+ * The exit code is 1 if any response differs or the server fails. Only POSIX
+ * systems are supported.
+ */
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <csignal>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "GraphGenerator.h"
+
+using namespace std;
+
+/** The OPTION lines each request is sent with; the first variant adds none. */
+const char* const VARIANTS[] = {
+    "",
+    "OPTION timeLimitMs 600000\n",
+    "OPTION enableHyperedgesFromCommonSource true\n",
+    "OPTION splitComponents true\n",
+    "OPTION progressive true\n"
+};
+
+const int VARIANT_COUNT = sizeof(VARIANTS) / sizeof(VARIANTS[0]);
+
+/** A request with hyperedges and route states. */
+const char* const NET_REQUEST =
+    "OPTION edgeRouting ORTHOGONAL\n"
+    "OPTION enableHyperedgesFromCommonSource true\n"
+    "OPTION timeLimitMs 600000\n"
+    "GRAPH\n"
+    "NODE 1 0 0 40 40 0 0\n"
+    "NODE 2 200 -100 240 -60 0 1\n"
+    "NODE 3 200 0 240 40 0 1\n"
+    "NODE 4 200 100 240 140 0 1\n"
+    "NODE 5 0 200 40 240 1 0\n"
+    "PORT 10 1 EAST 42.5 20\n"
+    "PORT 11 1 SOUTH 20 42.5\n"
+    "PEDGE 20 1 2 10 0\n"
+    "PEDGE 21 1 3 10 0\n"
+    "PEDGE 22 1 4 10 0\n"
+    "PEDGE 23 1 5 11 0\n"
+    "EDGE 24 2 5 0 0\n"
+    "GRAPHEND\n";
+
+/** The frame types of the binary protocol, see BinaryProtocol.h. */
+const unsigned char FRAME_TEXT = 0x01;
+const unsigned char FRAME_NODE = 0x02;
+const unsigned char FRAME_PORT = 0x03;
+const unsigned char FRAME_EDGE = 0x04;
+const unsigned char FRAME_CLUSTER = 0x05;
+const unsigned char FRAME_LAYOUT = 0x81;
+
+/** The route of an edge as decoded from either protocol. */
+struct EdgeRoute {
+    unsigned int id;
+    /** the state of the route, empty if the response has none. */
+    string state;
+    vector<double> points;
+};
+
+/** A LAYOUT response. */
+struct Layout {
+    vector<EdgeRoute> edges;
+    vector<string> hyperedges;
+};
+
+static vector<string> split(const string& text, char separator) {
+    vector<string> parts;
+    istringstream in(text);
+    string part;
+    while (getline(in, part, separator)) {
+        if (!part.empty()) {
+            parts.push_back(part);
+        }
+    }
+    return parts;
+}
+
+static void putU8(string& buffer, unsigned int value) {
+    buffer += (char) (value & 0xff);
+}
+
+static void putU32(string& buffer, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        buffer += (char) ((value >> (8 * i)) & 0xff);
+    }
+}
+
+static void putU64(string& buffer, uint64_t value) {
+    putU32(buffer, (uint32_t) value);
+    putU32(buffer, (uint32_t) (value >> 32));
+}
+
+static void putF64(string& buffer, double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    for (int i = 0; i < 8; ++i) {
+        buffer += (char) ((bits >> (8 * i)) & 0xff);
+    }
+}
+
+static uint32_t getU32(const char*& data) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+    data += 4;
+    return (uint32_t) bytes[0] | ((uint32_t) bytes[1] << 8) | ((uint32_t) bytes[2] << 16)
+            | ((uint32_t) bytes[3] << 24);
+}
+
+static double getF64(const char*& data) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+    data += 8;
+    uint64_t bits = 0;
+    for (int i = 7; i >= 0; --i) {
+        bits = (bits << 8) | bytes[i];
+    }
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/** Appends the pending records as a frame of the given type. */
+static void flushFrame(string& out, unsigned char type, string& payload) {
+    if (!payload.empty()) {
+        putU32(out, (uint32_t) payload.size());
+        putU8(out, type);
+        out += payload;
+        payload.clear();
+    }
+}
+
+static unsigned char portSide(const string& side) {
+    return side == "NORTH" ? 0 : side == "EAST" ? 1 : side == "SOUTH" ? 2 : 3;
+}
+
+/**
+ * Encodes a request of the text protocol as frames. Lines of consecutive
+ * records of the same type go into one frame, all other lines into TEXT frames.
+ */
+static string encodeRequest(const string& request) {
+    string frames;
+    string payload;
+    unsigned char type = FRAME_TEXT;
+    istringstream lines(request);
+    string line;
+    while (getline(lines, line)) {
+        vector<string> tokens = split(line, ' ');
+        const string keyword = tokens.empty() ? "" : tokens[0];
+        unsigned char lineType = FRAME_TEXT;
+        if (keyword == "NODE" && tokens.size() == 8) {
+            lineType = FRAME_NODE;
+        } else if (keyword == "CLUSTER" && tokens.size() == 6) {
+            lineType = FRAME_CLUSTER;
+        } else if (keyword == "PORT" && tokens.size() == 6) {
+            lineType = FRAME_PORT;
+        } else if ((keyword == "EDGE" || keyword == "PEDGE" || keyword == "EDGEP"
+                || keyword == "PEDGEP") && tokens.size() == 6) {
+            lineType = FRAME_EDGE;
+        }
+        if (lineType != type) {
+            flushFrame(frames, type, payload);
+            type = lineType;
+        }
+
+        switch (lineType) {
+        case FRAME_NODE:
+            putU64(payload, strtoull(tokens[1].c_str(), NULL, 10));
+            for (int i = 2; i < 6; ++i) {
+                putF64(payload, strtod(tokens[i].c_str(), NULL));
+            }
+            putU32(payload, (uint32_t) atoi(tokens[6].c_str()));
+            putU32(payload, (uint32_t) atoi(tokens[7].c_str()));
+            break;
+
+        case FRAME_CLUSTER:
+            putU64(payload, strtoull(tokens[1].c_str(), NULL, 10));
+            for (int i = 2; i < 6; ++i) {
+                putF64(payload, strtod(tokens[i].c_str(), NULL));
+            }
+            break;
+
+        case FRAME_PORT:
+            putU64(payload, strtoull(tokens[1].c_str(), NULL, 10));
+            putU64(payload, strtoull(tokens[2].c_str(), NULL, 10));
+            putU8(payload, portSide(tokens[3]));
+            putF64(payload, strtod(tokens[4].c_str(), NULL));
+            putF64(payload, strtod(tokens[5].c_str(), NULL));
+            break;
+
+        case FRAME_EDGE: {
+            bool sourcePort = keyword == "PEDGEP" || keyword == "PEDGE";
+            bool targetPort = keyword == "PEDGEP" || keyword == "EDGEP";
+            putU8(payload, (sourcePort ? 1 : 0) | (targetPort ? 2 : 0));
+            putU32(payload, strtoul(tokens[1].c_str(), NULL, 10));
+            for (int i = 2; i < 6; ++i) {
+                bool unused = (i == 4 && !sourcePort) || (i == 5 && !targetPort);
+                putU64(payload, unused ? 0 : strtoull(tokens[i].c_str(), NULL, 10));
+            }
+            break;
+        }
+
+        default:
+            payload += line;
+            payload += '\n';
+            break;
+        }
+    }
+    flushFrame(frames, type, payload);
+    return frames;
+}
+
+/**
+ * Runs the server on the given input.
+ *
+ * @return false if the server cannot be run or fails
+ */
+static bool runServer(const string& server, const vector<string>& args, const string& input,
+        string& output) {
+    char outputPath[] = "/tmp/protocol-check-XXXXXX";
+    int outputFd = mkstemp(outputPath);
+    if (outputFd < 0) {
+        perror("mkstemp");
+        return false;
+    }
+    unlink(outputPath);
+    int toServer[2];
+    if (pipe(toServer) != 0) {
+        perror("pipe");
+        close(outputFd);
+        return false;
+    }
+    pid_t pid = fork();
+    if (pid == 0) {
+        // the response goes to a file, so the input can be written at once
+        dup2(toServer[0], 0);
+        dup2(outputFd, 1);
+        close(toServer[0]);
+        close(toServer[1]);
+        close(outputFd);
+        vector<char*> argv;
+        argv.push_back(const_cast<char*>(server.c_str()));
+        for (size_t i = 0; i < args.size(); ++i) {
+            argv.push_back(const_cast<char*>(args[i].c_str()));
+        }
+        argv.push_back(NULL);
+        execv(server.c_str(), &argv[0]);
+        perror("execv");
+        _exit(127);
+    }
+    close(toServer[0]);
+    if (pid < 0) {
+        perror("fork");
+        close(toServer[1]);
+        close(outputFd);
+        return false;
+    }
+
+    for (size_t done = 0; done < input.size();) {
+        ssize_t count = write(toServer[1], input.data() + done, input.size() - done);
+        if (count <= 0) {
+            break;
+        }
+        done += count;
+    }
+    close(toServer[1]);
+    int status;
+    bool ok = waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+
+    output.clear();
+    lseek(outputFd, 0, SEEK_SET);
+    char buffer[1 << 16];
+    for (ssize_t count; (count = read(outputFd, buffer, sizeof(buffer))) > 0;) {
+        output.append(buffer, count);
+    }
+    close(outputFd);
+    return ok;
+}
+
+/** Decodes the LAYOUT responses of the text protocol. */
+static bool decodeText(const string& output, vector<Layout>& layouts) {
+    istringstream lines(output);
+    string line;
+    while (getline(lines, line)) {
+        if (line == "LAYOUT") {
+            layouts.push_back(Layout());
+        } else if (line.compare(0, 5, "EDGE ") == 0 && !layouts.empty()) {
+            size_t equals = line.find('=');
+            if (equals == string::npos) {
+                cerr << "ERROR: invalid edge line " << line << "." << endl;
+                return false;
+            }
+            EdgeRoute edge;
+            istringstream head(line.substr(5, equals - 5));
+            head >> edge.id >> edge.state;
+            const char* c = line.c_str() + equals + 1;
+            for (char* end;; c = end) {
+                double value = strtod(c, &end);
+                if (end == c) {
+                    break;
+                }
+                edge.points.push_back(value);
+            }
+            layouts.back().edges.push_back(edge);
+        } else if (line.compare(0, 9, "HYPEREDGE") == 0 && !layouts.empty()) {
+            layouts.back().hyperedges.push_back(line);
+        }
+    }
+    return true;
+}
+
+/** Decodes the LAYOUT frames and the ROUTE and HYPEREDGE lines following them. */
+static bool decodeBinary(const string& output, vector<Layout>& layouts) {
+    size_t handshake = output.find('\n');
+    if (handshake == string::npos || output.compare(0, handshake, "PROTOCOL BINARY 2") != 0) {
+        cerr << "ERROR: the server did not accept the binary protocol." << endl;
+        return false;
+    }
+    const char* data = output.data() + handshake + 1;
+    const char* end = output.data() + output.size();
+    while (end - data >= 5) {
+        uint32_t length = getU32(data);
+        unsigned char type = (unsigned char) *data++;
+        if ((size_t) (end - data) < length) {
+            cerr << "ERROR: incomplete frame." << endl;
+            return false;
+        }
+        const char* frameEnd = data + length;
+        if (type == FRAME_LAYOUT) {
+            layouts.push_back(Layout());
+            uint32_t count = getU32(data);
+            for (uint32_t i = 0; i < count && data < frameEnd; ++i) {
+                EdgeRoute edge;
+                edge.id = getU32(data);
+                uint32_t points = getU32(data);
+                for (uint32_t j = 0; j < 2 * points && data < frameEnd; ++j) {
+                    edge.points.push_back(getF64(data));
+                }
+                layouts.back().edges.push_back(edge);
+            }
+        } else if (type == FRAME_TEXT && !layouts.empty()) {
+            Layout& layout = layouts.back();
+            istringstream lines(string(data, frameEnd));
+            string line;
+            while (getline(lines, line)) {
+                if (line.compare(0, 6, "ROUTE ") == 0) {
+                    istringstream route(line.substr(6));
+                    unsigned int id;
+                    string state;
+                    route >> id >> state;
+                    for (size_t i = 0; i < layout.edges.size(); ++i) {
+                        if (layout.edges[i].id == id) {
+                            layout.edges[i].state = state;
+                        }
+                    }
+                } else if (line.compare(0, 9, "HYPEREDGE") == 0) {
+                    layout.hyperedges.push_back(line);
+                }
+            }
+        }
+        data = frameEnd;
+    }
+    return true;
+}
+
+/**
+ * Compares the responses of both protocols.
+ *
+ * @return an empty string if they are equal, otherwise the first difference
+ */
+static string compareLayouts(const vector<Layout>& text, const vector<Layout>& binary) {
+    ostringstream difference;
+    if (text.size() != binary.size()) {
+        difference << text.size() << " text layouts, " << binary.size() << " binary layouts";
+        return difference.str();
+    }
+    for (size_t l = 0; l < text.size(); ++l) {
+        const vector<EdgeRoute>& textEdges = text[l].edges;
+        const vector<EdgeRoute>& binaryEdges = binary[l].edges;
+        if (textEdges.size() != binaryEdges.size()) {
+            difference << "layout " << l + 1 << ": " << textEdges.size() << " text edges, "
+                    << binaryEdges.size() << " binary edges";
+            return difference.str();
+        }
+        for (size_t i = 0; i < textEdges.size(); ++i) {
+            const EdgeRoute& a = textEdges[i];
+            const EdgeRoute& b = binaryEdges[i];
+            if (a.id != b.id) {
+                difference << "layout " << l + 1 << ": edge " << a.id << " as text, " << b.id
+                        << " as binary";
+                return difference.str();
+            }
+            if (a.state != b.state) {
+                difference << "layout " << l + 1 << ": state of edge " << a.id << " is '"
+                        << a.state << "' as text, '" << b.state << "' as binary";
+                return difference.str();
+            }
+            if (a.points != b.points) {
+                difference << "layout " << l + 1 << ": route of edge " << a.id << " differs";
+                return difference.str();
+            }
+        }
+        if (text[l].hyperedges != binary[l].hyperedges) {
+            difference << "layout " << l + 1 << ": hyperedges differ";
+            return difference.str();
+        }
+    }
+    return "";
+}
+
+/**
+ * Sends a request in both protocols and compares the responses.
+ *
+ * @param edges
+ *            set to the number of edges of the last text response
+ * @return an empty string if the responses are equal, otherwise the problem
+ */
+static string checkRequest(const string& server, const vector<string>& args,
+        const string& request, size_t& edges) {
+    string textOutput;
+    string binaryOutput;
+    vector<Layout> text;
+    vector<Layout> binary;
+    edges = 0;
+    if (!runServer(server, args, request + "[CHUNK]\n", textOutput)
+            || !runServer(server, args, "PROTOCOL BINARY 2\n" + encodeRequest(request),
+                    binaryOutput)) {
+        return "server failed";
+    }
+    if (!decodeText(textOutput, text) || !decodeBinary(binaryOutput, binary)) {
+        return "invalid response";
+    }
+    if (text.empty()) {
+        return "no response";
+    }
+    edges = text.back().edges.size() + text.back().hyperedges.size();
+    return compareLayouts(text, binary);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        cerr << "ERROR: usage: protocol-check {server} [--families {f,...}] [--sizes {n,...}]"
+                " [--arg {server argument}]..." << endl;
+        return 1;
+    }
+    string server = argv[1];
+    vector<string> families;
+    for (int i = 0; i < FAMILY_COUNT; ++i) {
+        families.push_back(familyName((GraphFamily) i));
+    }
+    vector<string> sizes = split("100,1000", ',');
+    vector<string> args;
+    for (int i = 2; i < argc; ++i) {
+        if (strcmp(argv[i], "--families") == 0 && i + 1 < argc) {
+            families = split(argv[++i], ',');
+        } else if (strcmp(argv[i], "--sizes") == 0 && i + 1 < argc) {
+            sizes = split(argv[++i], ',');
+        } else if (strcmp(argv[i], "--arg") == 0 && i + 1 < argc) {
+            args.push_back(argv[++i]);
+        } else {
+            cerr << "ERROR: invalid argument " << argv[i] << "." << endl;
+            return 1;
+        }
+    }
+    // a server that fails must not end the check
+    signal(SIGPIPE, SIG_IGN);
+
+    unsigned int failed = 0;
+    unsigned int checked = 1;
+    size_t edges;
+    string result = checkRequest(server, args, NET_REQUEST, edges);
+    if (!result.empty()) {
+        ++failed;
+    }
+    cout << "family\tsize\toptions\tedges\tresult" << endl;
+    cout << "net\t-\t-\t" << edges << "\t" << (result.empty() ? "OK" : result) << endl;
+    for (size_t f = 0; f < families.size(); ++f) {
+        GraphFamily family;
+        if (!parseFamily(families[f].c_str(), family)) {
+            cerr << "ERROR: unknown family " << families[f] << "." << endl;
+            return 1;
+        }
+        for (size_t s = 0; s < sizes.size(); ++s) {
+            unsigned int size = atoi(sizes[s].c_str());
+            for (int v = 0; v < VARIANT_COUNT; ++v) {
+                unsigned int elements;
+                string request = generateRequest(family, size, 1, false, VARIANTS[v], elements);
+                result = checkRequest(server, args, request, edges);
+
+                string options = VARIANTS[v];
+                options = options.empty() ? "-" : options.substr(7, options.size() - 8);
+                ++checked;
+                if (!result.empty()) {
+                    ++failed;
+                }
+                cout << families[f] << "\t" << size << "\t" << options << "\t" << edges << "\t"
+                        << (result.empty() ? "OK" : result) << endl;
+            }
+        }
+    }
+    cout << checked << " requests, " << failed << " with different responses" << endl;
+    return failed > 0 ? 1 : 0;
+}
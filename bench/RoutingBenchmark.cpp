@@ -0,0 +1,369 @@
+/**
+ * @file    RoutingBenchmark.cpp
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * End-to-end benchmark of the routing server. For every graph family and size,
+ * a server process is started and fed generated requests through the chunked
+ * stdin protocol. Each request asks for STATS, so besides the latency seen by
+ * the client the time of each phase and the memory peak of the request are
+ * recorded. The peak RSS of the server is taken from the resource usage of the
+ * terminated process.
+ *
+ * The results are written as tab-separated values, one line per family and
+ * size, and two result files can be compared with the compare command. Layout
+ * options such as the pin strategy are compared by running twice with
+ * different --option values; the average number of route points reflects the
+ * bends of the resulting layout.
+ *
+ * Usage:
+ *   routing-benchmark generate {family} {elements} [{seed}]
+ *   routing-benchmark run {server} [--families {f,...}] [--sizes {n,...}]
+ *                     [--repeat {n}] [--arg {server argument}]...
+ *                     [--option "{id} {value}"]...
+ *   routing-benchmark compare {baseline.tsv} {candidate.tsv}
+ *
+ * Only POSIX systems are supported by the run command.
+ */
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <csignal>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+#include "GraphGenerator.h"
+
+using namespace std;
+
+/** The phases reported in the STATS block, in the order of the result columns. */
+const char* const PHASES[] = { "parseMs", "shapesMs", "pinsMs", "connectorsMs", "routingMs",
+        "hyperedgesMs", "outputMs" };
+const int PHASE_COUNT = sizeof(PHASES) / sizeof(PHASES[0]);
+
+/** The columns of a result line. */
+const char* const HEADER = "family\tsize\telements\trequests\tp50Ms\tp95Ms\tp99Ms\trequestsPerSec"
+        "\tparseMs\tshapesMs\tpinsMs\tconnectorsMs\troutingMs\thyperedgesMs\toutputMs\troutePoints"
+        "\tmemoryPeakBytes\tpeakRssKb";
+
+/**
+ * A running server process connected through pipes.
+ */
+class Server {
+public:
+    Server(const string& path, const vector<string>& args) :
+        mPid(-1), mIn(NULL), mOut(NULL) {
+        int toServer[2];
+        int fromServer[2];
+        if (pipe(toServer) != 0 || pipe(fromServer) != 0) {
+            perror("pipe");
+            return;
+        }
+        mPid = fork();
+        if (mPid == 0) {
+            dup2(toServer[0], 0);
+            dup2(fromServer[1], 1);
+            close(toServer[0]);
+            close(toServer[1]);
+            close(fromServer[0]);
+            close(fromServer[1]);
+            vector<char*> argv;
+            argv.push_back(const_cast<char*>(path.c_str()));
+            for (size_t i = 0; i < args.size(); ++i) {
+                argv.push_back(const_cast<char*>(args[i].c_str()));
+            }
+            argv.push_back(NULL);
+            execv(path.c_str(), &argv[0]);
+            perror("execv");
+            _exit(127);
+        }
+        close(toServer[0]);
+        close(fromServer[1]);
+        mIn = fdopen(toServer[1], "w");
+        mOut = fdopen(fromServer[0], "r");
+    }
+
+    bool ok() const {
+        return mPid > 0 && mIn != NULL && mOut != NULL;
+    }
+
+    /**
+     * Sends a request and reads its response.
+     *
+     * @param stats
+     *            set to the values of the STATS block
+     * @return false if the server did not answer
+     */
+    bool request(const string& text, map<string, double>& stats) {
+        if (fwrite(text.data(), 1, text.size(), mIn) != text.size()
+                || fputs("[CHUNK]\n", mIn) == EOF || fflush(mIn) != 0) {
+            return false;
+        }
+        // the response is complete with the end of the STATS block
+        bool inStats = false;
+        char line[4096];
+        while (fgets(line, sizeof(line), mOut) != NULL) {
+            if (strcmp(line, "STATSEND\n") == 0) {
+                return true;
+            } else if (strcmp(line, "STATS\n") == 0) {
+                inStats = true;
+            } else if (inStats) {
+                char name[64];
+                double value;
+                if (sscanf(line, "%63s %lf", name, &value) == 2) {
+                    stats[name] = value;
+                }
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Closes the input of the server and waits for it to terminate.
+     *
+     * @return the peak resident set size of the server in KiB
+     */
+    long finish() {
+        if (mIn != NULL) {
+            fclose(mIn);
+            mIn = NULL;
+        }
+        if (mOut != NULL) {
+            fclose(mOut);
+            mOut = NULL;
+        }
+        struct rusage usage;
+        int status;
+        if (mPid <= 0 || wait4(mPid, &status, 0, &usage) < 0) {
+            return -1;
+        }
+        mPid = -1;
+        return usage.ru_maxrss;
+    }
+
+private:
+    pid_t mPid;
+    FILE* mIn;
+    FILE* mOut;
+};
+
+static vector<string> split(const string& text, char separator) {
+    vector<string> parts;
+    istringstream in(text);
+    for (string part; getline(in, part, separator);) {
+        if (!part.empty()) {
+            parts.push_back(part);
+        }
+    }
+    return parts;
+}
+
+/** @return the percentile of the sorted values, by the nearest-rank method */
+static double percentile(const vector<double>& sorted, double p) {
+    size_t rank = (size_t) (p / 100.0 * sorted.size() + 0.999999);
+    return sorted[min(sorted.size(), max<size_t>(rank, 1)) - 1];
+}
+
+static int generate(int argc, char* argv[]) {
+    GraphFamily family;
+    if (argc < 4 || !parseFamily(argv[2], family)) {
+        cerr << "ERROR: usage: routing-benchmark generate {family} {elements} [{seed}]" << endl;
+        return 1;
+    }
+    unsigned int elements;
+    cout << generateRequest(family, atoi(argv[3]), argc > 4 ? atoi(argv[4]) : 1, false, "",
+            elements);
+    return 0;
+}
+
+static int run(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "ERROR: usage: routing-benchmark run {server} [options]" << endl;
+        return 1;
+    }
+    string server = argv[2];
+    vector<string> families;
+    for (int i = 0; i < FAMILY_COUNT; ++i) {
+        families.push_back(familyName((GraphFamily) i));
+    }
+    vector<string> sizes = split("100,1000,10000", ',');
+    int repeat = 5;
+    vector<string> serverArgs;
+    string options;
+    for (int i = 3; i < argc; ++i) {
+        if (strcmp(argv[i], "--families") == 0 && i + 1 < argc) {
+            families = split(argv[++i], ',');
+        } else if (strcmp(argv[i], "--sizes") == 0 && i + 1 < argc) {
+            sizes = split(argv[++i], ',');
+        } else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = max(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--arg") == 0 && i + 1 < argc) {
+            serverArgs.push_back(argv[++i]);
+        } else if (strcmp(argv[i], "--option") == 0 && i + 1 < argc) {
+            options += string("OPTION ") + argv[++i] + "\n";
+        } else {
+            cerr << "ERROR: invalid argument " << argv[i] << "." << endl;
+            return 1;
+        }
+    }
+    signal(SIGPIPE, SIG_IGN);
+
+    cout << HEADER << endl;
+    for (size_t f = 0; f < families.size(); ++f) {
+        GraphFamily family;
+        if (!parseFamily(families[f].c_str(), family)) {
+            cerr << "ERROR: unknown family " << families[f] << "." << endl;
+            return 1;
+        }
+        for (size_t s = 0; s < sizes.size(); ++s) {
+            unsigned int size = atoi(sizes[s].c_str());
+            unsigned int elements = 0;
+            vector<string> requests;
+            for (int r = 0; r < repeat; ++r) {
+                requests.push_back(generateRequest(family, size, r + 1, true, options, elements));
+            }
+
+            Server process(server, serverArgs);
+            if (!process.ok()) {
+                return 1;
+            }
+            vector<double> latencies;
+            double phases[PHASE_COUNT] = { 0 };
+            double routePoints = 0;
+            double memoryPeak = 0;
+            chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+            for (int r = 0; r < repeat; ++r) {
+                map<string, double> stats;
+                chrono::steady_clock::time_point start = chrono::steady_clock::now();
+                if (!process.request(requests[r], stats)) {
+                    cerr << "ERROR: no response for " << families[f] << " " << size << "." << endl;
+                    break;
+                }
+                latencies.push_back(chrono::duration<double, milli>(
+                        chrono::steady_clock::now() - start).count());
+                for (int p = 0; p < PHASE_COUNT; ++p) {
+                    phases[p] += stats[PHASES[p]];
+                }
+                routePoints += stats["routePoints"];
+                memoryPeak = max(memoryPeak, stats["memoryPeakBytes"]);
+            }
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+            long peakRss = process.finish();
+            if (latencies.empty()) {
+                continue;
+            }
+
+            sort(latencies.begin(), latencies.end());
+            cout << families[f] << "\t" << size << "\t" << elements << "\t" << latencies.size()
+                    << "\t" << percentile(latencies, 50) << "\t" << percentile(latencies, 95)
+                    << "\t" << percentile(latencies, 99) << "\t" << latencies.size() / seconds;
+            // phases are averaged over the requests
+            for (int p = 0; p < PHASE_COUNT; ++p) {
+                cout << "\t" << phases[p] / latencies.size();
+            }
+            cout << "\t" << routePoints / latencies.size() << "\t" << (long long) memoryPeak
+                    << "\t" << peakRss << endl;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Reads a result file into a map from family and size to the columns.
+ */
+static bool readResults(const char* path, vector<string>& header,
+        map<string, vector<string> >& results) {
+    ifstream in(path);
+    if (!in) {
+        cerr << "ERROR: could not read " << path << "." << endl;
+        return false;
+    }
+    string line;
+    if (getline(in, line)) {
+        header = split(line, '\t');
+    }
+    while (getline(in, line)) {
+        vector<string> columns = split(line, '\t');
+        if (columns.size() == header.size()) {
+            results[columns[0] + "\t" + columns[1]] = columns;
+        }
+    }
+    return true;
+}
+
+static int compare(int argc, char* argv[]) {
+    vector<string> header;
+    vector<string> candidateHeader;
+    map<string, vector<string> > baseline;
+    map<string, vector<string> > candidate;
+    if (argc < 4) {
+        cerr << "ERROR: usage: routing-benchmark compare {baseline.tsv} {candidate.tsv}" << endl;
+        return 1;
+    }
+    if (!readResults(argv[2], header, baseline) || !readResults(argv[3], candidateHeader, candidate)) {
+        return 1;
+    }
+    if (header != candidateHeader) {
+        cerr << "ERROR: the result files have different columns." << endl;
+        return 1;
+    }
+
+    // candidate / baseline for every measured column; below 1 is an improvement
+    cout << "family\tsize";
+    for (size_t c = 4; c < header.size(); ++c) {
+        cout << "\t" << header[c];
+    }
+    cout << endl;
+    for (map<string, vector<string> >::iterator it = baseline.begin(); it != baseline.end(); ++it) {
+        map<string, vector<string> >::iterator other = candidate.find(it->first);
+        if (other == candidate.end()) {
+            continue;
+        }
+        cout << it->first;
+        for (size_t c = 4; c < header.size(); ++c) {
+            double before = atof(it->second[c].c_str());
+            double after = atof(other->second[c].c_str());
+            cout << "\t";
+            if (before > 0) {
+                cout << after / before;
+            } else {
+                cout << "-";
+            }
+        }
+        cout << endl;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc >= 2 && strcmp(argv[1], "generate") == 0) {
+        return generate(argc, argv);
+    } else if (argc >= 2 && strcmp(argv[1], "run") == 0) {
+        return run(argc, argv);
+    } else if (argc >= 2 && strcmp(argv[1], "compare") == 0) {
+        return compare(argc, argv);
+    }
+    cerr << "ERROR: usage: routing-benchmark generate|run|compare ..." << endl;
+    return 1;
+}
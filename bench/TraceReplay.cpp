@@ -0,0 +1,215 @@
+/**
+ * @file    TraceReplay.cpp
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * Replays a request trace recorded with --record against a server binary. The
+ * requests are sent in the order of the trace to a server process that
+ * records them once more, and the two traces are compared: a request is
+ * flagged if the hash of its routes differs or if its routing phase, i.e.
+ * processTransaction(), takes longer than the recorded time by more than the
+ * threshold. With --repeat, the trace is replayed several times and the
+ * fastest routing time of each request counts, which reduces the noise.
+ *
+ * Usage:
+ *   trace-replay {server} {trace} [--threshold {percent}] [--min-ms {ms}]
+ *                [--repeat {n}] [--arg {server argument}]...
+ *
+ * The exit code is 1 if any request is flagged. Only POSIX systems are
+ * supported.
+ */
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <csignal>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "RequestTrace.h"
+
+using namespace std;
+
+/** The default relative slowdown of the routing phase that is flagged, in percent. */
+const double DEFAULT_THRESHOLD = 20;
+
+/** The default absolute slowdown below which requests are not flagged, in milliseconds. */
+const double DEFAULT_MIN_MS = 1;
+
+static bool readTrace(const string& path, vector<TraceRecord>& records) {
+    TraceReader reader;
+    if (!reader.open(path)) {
+        return false;
+    }
+    TraceRecord record;
+    while (reader.next(record)) {
+        records.push_back(record);
+    }
+    return true;
+}
+
+/**
+ * Sends the requests to a new server process, which records them.
+ *
+ * @return false if the server cannot be run
+ */
+static bool replay(const string& server, const vector<string>& args,
+        const vector<TraceRecord>& records, const string& tracePath) {
+    int toServer[2];
+    if (pipe(toServer) != 0) {
+        perror("pipe");
+        return false;
+    }
+    pid_t pid = fork();
+    if (pid == 0) {
+        // the responses are checked through the new trace only
+        int devNull = open("/dev/null", O_WRONLY);
+        dup2(toServer[0], 0);
+        dup2(devNull, 1);
+        close(toServer[0]);
+        close(toServer[1]);
+        close(devNull);
+        vector<char*> argv;
+        argv.push_back(const_cast<char*>(server.c_str()));
+        for (size_t i = 0; i < args.size(); ++i) {
+            argv.push_back(const_cast<char*>(args[i].c_str()));
+        }
+        argv.push_back(const_cast<char*>("--record"));
+        argv.push_back(const_cast<char*>(tracePath.c_str()));
+        argv.push_back(NULL);
+        execv(server.c_str(), &argv[0]);
+        perror("execv");
+        _exit(127);
+    }
+    close(toServer[0]);
+    if (pid < 0) {
+        perror("fork");
+        close(toServer[1]);
+        return false;
+    }
+
+    FILE* in = fdopen(toServer[1], "w");
+    for (size_t i = 0; i < records.size(); ++i) {
+        const string& request = records[i].request;
+        if (fwrite(request.data(), 1, request.size(), in) != request.size()
+                || fputs("[CHUNK]\n", in) == EOF) {
+            break;
+        }
+    }
+    fclose(in);
+    int status;
+    return waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "ERROR: usage: trace-replay {server} {trace} [--threshold {percent}]"
+                " [--min-ms {ms}] [--repeat {n}] [--arg {server argument}]..." << endl;
+        return 1;
+    }
+    string server = argv[1];
+    string tracePath = argv[2];
+    double threshold = DEFAULT_THRESHOLD;
+    double minMs = DEFAULT_MIN_MS;
+    int repeat = 1;
+    vector<string> args;
+    for (int i = 3; i < argc; ++i) {
+        if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+            threshold = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--min-ms") == 0 && i + 1 < argc) {
+            minMs = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = max(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--arg") == 0 && i + 1 < argc) {
+            args.push_back(argv[++i]);
+        } else {
+            cerr << "ERROR: invalid argument " << argv[i] << "." << endl;
+            return 1;
+        }
+    }
+
+    // a server that fails must not end the replay
+    signal(SIGPIPE, SIG_IGN);
+
+    vector<TraceRecord> recorded;
+    if (!readTrace(tracePath, recorded)) {
+        return 1;
+    }
+
+    char replayPath[] = "/tmp/trace-replay-XXXXXX";
+    int fd = mkstemp(replayPath);
+    if (fd < 0) {
+        perror("mkstemp");
+        return 1;
+    }
+    close(fd);
+
+    // the fastest routing time of each request over all repetitions
+    vector<double> routingMs(recorded.size(), -1);
+    vector<bool> differs(recorded.size(), false);
+    for (int run = 0; run < repeat; ++run) {
+        unlink(replayPath);
+        vector<TraceRecord> replayed;
+        if (!replay(server, args, recorded, replayPath) || !readTrace(replayPath, replayed)) {
+            cerr << "ERROR: the server failed to replay the trace." << endl;
+            unlink(replayPath);
+            return 1;
+        }
+        if (replayed.size() != recorded.size()) {
+            cerr << "ERROR: " << recorded.size() << " requests recorded, but " << replayed.size()
+                    << " replayed." << endl;
+            unlink(replayPath);
+            return 1;
+        }
+        for (size_t i = 0; i < recorded.size(); ++i) {
+            differs[i] = differs[i] || replayed[i].hash != recorded[i].hash;
+            double ms = replayed[i].phaseMs[PHASE_ROUTING];
+            routingMs[i] = routingMs[i] < 0 ? ms : min(routingMs[i], ms);
+        }
+    }
+    unlink(replayPath);
+
+    unsigned int different = 0;
+    unsigned int regressed = 0;
+    double recordedTotal = 0;
+    double replayedTotal = 0;
+    cout << "request\tid\trecordedMs\treplayedMs\tresult" << endl;
+    for (size_t i = 0; i < recorded.size(); ++i) {
+        double before = recorded[i].phaseMs[PHASE_ROUTING];
+        bool slower = routingMs[i] > before * (1 + threshold / 100)
+                && routingMs[i] - before >= minMs;
+        recordedTotal += before;
+        replayedTotal += routingMs[i];
+        if (differs[i]) {
+            ++different;
+        }
+        if (slower) {
+            ++regressed;
+        }
+        if (differs[i] || slower) {
+            cout << i + 1 << "\t" << (recorded[i].id.empty() ? "-" : recorded[i].id) << "\t"
+                    << before << "\t" << routingMs[i] << "\t"
+                    << (differs[i] ? (slower ? "ROUTES,SLOWER" : "ROUTES") : "SLOWER") << endl;
+        }
+    }
+    cout << recorded.size() << " requests, " << different << " with different routes, "
+            << regressed << " slower; routing " << recordedTotal << " ms recorded, "
+            << replayedTotal << " ms replayed" << endl;
+    return different > 0 || regressed > 0 ? 1 : 0;
+}
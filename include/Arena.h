@@ -0,0 +1,161 @@
+/**
+ * @file    Arena.h
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * Definition of a request-scoped arena. Memory is handed out by bumping a
+ * pointer through large blocks and is never freed individually; resetting the
+ * arena at the end of a request releases everything at once and keeps the
+ * blocks for the next request of the same thread. Containers use the arena
+ * through ArenaAllocator, which falls back to the heap without an arena, so
+ * the same types serve named sessions that outlive their request.
+ *
+ * The objects created by libavoid are not covered: libavoid deletes them
+ * itself.
+ */
+#ifndef __ARENA_H__INCLUDED__
+#define __ARENA_H__INCLUDED__
+
+#include <cstddef>
+#include <new>
+#include <stdint.h>
+#include <vector>
+
+class Arena {
+public:
+    /** Size of the first block. */
+    static const size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+    /** Blocks beyond this total size are freed upon reset. */
+    static const size_t MAX_RETAINED = 64 * 1024 * 1024;
+
+    Arena();
+
+    ~Arena();
+
+    /**
+     * @param size
+     *            number of bytes
+     * @param alignment
+     *            a power of two
+     * @return uninitialized memory that stays valid until the next reset
+     */
+    void* allocate(size_t size, size_t alignment) {
+        size_t offset = mUsed + ((0 - (uintptr_t) (mBlock + mUsed)) & (alignment - 1));
+        if (offset + size > mCapacity) {
+            return allocateBlock(size, alignment);
+        }
+        mUsed = offset + size;
+        return mBlock + offset;
+    }
+
+    /**
+     * Releases all memory handed out. If several blocks were needed, they are
+     * replaced by one block of their total size, so that the next request of
+     * the same size is served from a single block.
+     */
+    void reset();
+
+    /** @return the number of bytes held in blocks */
+    size_t reserved() const {
+        return mReserved;
+    }
+
+private:
+    void addBlock(size_t capacity);
+
+    void* allocateBlock(size_t size, size_t alignment);
+
+    /** all blocks; the last one is the current block. */
+    std::vector<char*> mBlocks;
+    char* mBlock;
+    size_t mUsed;
+    size_t mCapacity;
+    size_t mReserved;
+
+    Arena(const Arena&);
+    Arena& operator=(const Arena&);
+};
+
+/**
+ * @return the arena of the calling thread
+ */
+Arena& threadArena();
+
+/**
+ * Resets the arena of the calling thread when it goes out of scope.
+ */
+class ArenaScope {
+public:
+    ArenaScope() {
+    }
+
+    ~ArenaScope() {
+        threadArena().reset();
+    }
+
+private:
+    ArenaScope(const ArenaScope&);
+    ArenaScope& operator=(const ArenaScope&);
+};
+
+/**
+ * A standard allocator that takes memory from an arena, or from the heap if
+ * there is none. Deallocation is a no-op for arena memory.
+ */
+template<typename T>
+class ArenaAllocator {
+public:
+    typedef T value_type;
+
+    ArenaAllocator(Arena* arena = NULL) :
+        mArena(arena) {
+    }
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) :
+        mArena(other.arena()) {
+    }
+
+    T* allocate(size_t n) {
+        if (mArena != NULL) {
+            return static_cast<T*>(mArena->allocate(n * sizeof(T), alignof(T)));
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t) {
+        if (mArena == NULL) {
+            ::operator delete(p);
+        }
+    }
+
+    Arena* arena() const {
+        return mArena;
+    }
+
+private:
+    Arena* mArena;
+};
+
+template<typename T, typename U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+    return a.arena() == b.arena();
+}
+
+template<typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+    return a.arena() != b.arena();
+}
+
+#endif
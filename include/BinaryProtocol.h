@@ -0,0 +1,156 @@
+/**
+ * @file    BinaryProtocol.h
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * Definition of the binary protocol, an opt-in alternative to the text
+ * protocol that avoids formatting and parsing coordinates. A client selects it
+ * by sending the line PROTOCOL BINARY {version} first; the server answers with
+ * the protocol it uses from then on. Only version 2 is supported; version 1
+ * carried 32 bit ids.
+ *
+ * All messages are frames [u32 payload length][u8 frame type][payload]. Numbers
+ * are little-endian, doubles are IEEE 754. A frame holds one or more records of
+ * its type:
+ *
+ *   TEXT     any line of the text protocol, e.g. OPTION or GRAPHEND
+ *   NODE     u64 id, f64 x1 y1 x2 y2, i32 incoming outgoing
+ *   PORT     u64 id, u64 node, u8 side, f64 x y
+ *   EDGE     u8 flags (1 = source port, 2 = target port), u32 id, u64 source
+ *            target sourcePort targetPort
+ *   CLUSTER  u64 id, f64 x1 y1 x2 y2
+ *
+ * A request ends with a TEXT frame holding GRAPHEND or SESSIONEND and is
+ * always answered by a LAYOUT frame: u32 edge count, then per edge u32 id,
+ * u32 point count and the points as pairs of f64. If the request has a time
+ * limit or has been cancelled, the states of the routes follow as a TEXT frame,
+ * and hyperedges as a TEXT frame of HYPEREDGE lines.
+ * Statistics requested with STATS follow as a TEXT frame.
+ */
+#ifndef __BINARYPROTOCOL_H__INCLUDED__
+#define __BINARYPROTOCOL_H__INCLUDED__
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "libavoid/libavoid.h"
+#include "GraphRecords.h"
+#include "RoutingControl.h"
+#include "LayoutWriter.h"
+
+/** The handshake line selecting the binary protocol, with its version. */
+#define PROTOCOL_BINARY "PROTOCOL BINARY 2"
+/** The handshake answer if the text protocol is kept. */
+#define PROTOCOL_TEXT "PROTOCOL TEXT"
+
+enum FrameType {
+    FRAME_TEXT = 0x01,
+    FRAME_NODE = 0x02,
+    FRAME_PORT = 0x03,
+    FRAME_EDGE = 0x04,
+    FRAME_CLUSTER = 0x05,
+    FRAME_LAYOUT = 0x81
+};
+
+/** Sizes of the encoded records. */
+const size_t NODE_RECORD_SIZE = 8 + 4 * 8 + 2 * 4;
+const size_t PORT_RECORD_SIZE = 8 + 8 + 1 + 2 * 8;
+const size_t EDGE_RECORD_SIZE = 1 + 4 + 4 * 8;
+const size_t CLUSTER_RECORD_SIZE = 8 + 4 * 8;
+
+/**
+ * A source of raw bytes.
+ */
+class ByteSource {
+public:
+    virtual ~ByteSource() {
+    }
+
+    /**
+     * Reads exactly the given number of bytes.
+     *
+     * @return false if the end of input is reached before
+     */
+    virtual bool read(char* data, size_t count) = 0;
+};
+
+/**
+ * Reads the next frame.
+ *
+ * @param in
+ *            the byte source
+ * @param type
+ *            set to the frame type
+ * @param payload
+ *            set to the payload of the frame
+ * @return false at the end of input
+ */
+bool readFrame(ByteSource& in, unsigned char& type, std::vector<char>& payload);
+
+/**
+ * Decoding records; each function advances the pointer behind the record
+ */
+void decodeNode(const char*& data, NodeRecord& node);
+
+void decodeCluster(const char*& data, ClusterRecord& cluster);
+
+bool decodePort(const char*& data, PortRecord& port);
+
+void decodeEdge(const char*& data, EdgeRecord& edge);
+
+/**
+ * @return the size of the payload of a LAYOUT frame with the routes of the
+ *         connectors
+ */
+size_t layoutSize(const std::vector<Avoid::ConnRef*>& cons, const RouteReport* report = NULL);
+
+/**
+ * Encodes the routes of the connectors like the payload of a LAYOUT frame,
+ * e.g. directly into shared memory. With a report, its fallback routes are
+ * encoded.
+ *
+ * @param data
+ *            the buffer, which must hold at least layoutSize() bytes
+ */
+void encodeLayout(char* data, const std::vector<Avoid::ConnRef*>& cons,
+        const RouteReport* report = NULL);
+
+/**
+ * @return the ROUTE {id} {state} lines of the connectors
+ */
+std::string routeStates(const std::vector<Avoid::ConnRef*>& cons, const RouteReport& report);
+
+/**
+ * @return the HYPEREDGE lines of the hyperedges
+ */
+std::string hyperedgeLines(const std::vector<Hyperedge>& hyperedges);
+
+/**
+ * Writes the routes of the connectors as a LAYOUT frame. With a report, its
+ * fallback routes are written and the states of the routes follow in a TEXT
+ * frame of ROUTE {id} {state} lines. Hyperedges follow as a TEXT frame of
+ * HYPEREDGE lines.
+ *
+ * @return the number of bytes written
+ */
+size_t writeLayoutFrame(std::ostream& out, const std::vector<Avoid::ConnRef*>& cons,
+        const RouteReport* report = NULL, const std::vector<Hyperedge>* hyperedges = NULL);
+
+/**
+ * Writes text, e.g. a STATS block, as a TEXT frame.
+ */
+void writeTextFrame(std::ostream& out, const std::string& text);
+
+#endif
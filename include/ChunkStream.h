@@ -19,27 +19,42 @@
  * specified on construction is treated as end-of-file. After such a delimiter has
  * been read no more reading operations can be performed on the stream until the
  * stream is explicitly restarted by moving it to the next chunk of data.
+ *
+ * The input is read in large blocks, either from a file descriptor or from the
+ * wrapped stream buffer. The delimiter is found by scanning for its first
+ * character with char_traits::find (memchr for char). Besides the usual
+ * istream interface, whole lines can be taken directly from the buffer with
+ * nextLine() without copying them.
  */
 
 #ifndef __CHUNKSTREAM_H__INCLUDED__
 #define __CHUNKSTREAM_H__INCLUDED__
 
 #include <string>
+#include <algorithm>
 #include <streambuf>
+#include <istream>
 #include <cassert>
+#include <cerrno>
+#include <cstring>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
 template<class _E, class _Tr = std::char_traits<_E> >
 class ChunkStreamBuffer: public std::basic_streambuf<_E, _Tr> {
 public:
-	/** the buffer size. */
-	static const size_t BUFF_SIZE = 1024;
+	/** the size of the blocks read at once. */
+	static const size_t BUFF_SIZE = 64 * 1024;
 
 	typedef typename _Tr::int_type int_type;
 	typedef typename _Tr::pos_type pos_type;
 	typedef typename _Tr::off_type off_type;
 
 	/**
-	 * Constructs the ChunkStreamBuffer.
+	 * Constructs the ChunkStreamBuffer reading from a stream buffer.
 	 *
 	 * @param buf
 	 *            the wrapped stream buffer
@@ -49,15 +64,23 @@ public:
 	 */
 	explicit ChunkStreamBuffer(std::basic_streambuf<_E, _Tr>& buf,
 			const std::basic_string<_E>& delimiter) :
-		mStreamBuf(buf), mInBuf(new _E[BUFF_SIZE + delimiter.size()]),
-				mChunkCompleted(false), mRealEof(false) {
-		assert(delimiter.size() > 0 && delimiter.size() < BUFF_SIZE);
-		mDelimiterLen = delimiter.size();
-		// copy the keyword
-		mDelimiter = new _E[mDelimiterLen];
-		_Tr::copy(mDelimiter, delimiter.c_str(), mDelimiterLen);
-		// initialize the get pointer
-		this->setg(0, 0, 0);
+		mStreamBuf(&buf), mFd(-1) {
+		init(delimiter);
+	}
+
+	/**
+	 * Constructs the ChunkStreamBuffer reading directly from a file descriptor.
+	 * Only meaningful for narrow characters.
+	 *
+	 * @param fd
+	 *            the file descriptor, e.g. 0 for stdin
+	 * @param delimiter
+	 *            the delimiter that seperates the chunks; has to be smaller
+	 *            than BUFF_SIZE
+	 */
+	explicit ChunkStreamBuffer(int fd, const std::basic_string<_E>& delimiter) :
+		mStreamBuf(0), mFd(fd) {
+		init(delimiter);
 	}
 
 	virtual ~ChunkStreamBuffer() {
@@ -76,87 +99,300 @@ public:
 	 * @return true if the real eof is reached; false else
 	 */
 	inline bool isRealEof() {
-		return mRealEof;
+		return mRealEof && mBegin == mEnd;
 	}
 
+	/**
+	 * Takes the next line of the current chunk from the buffer. The line
+	 * break is replaced by a null character; the line stays valid until
+	 * the buffer is read again.
+	 *
+	 * @param line
+	 *            set to the first character of the line
+	 * @param length
+	 *            set to the length of the line without line break
+	 * @return true if a line was read; false at the end of the chunk
+	 */
+	bool nextLine(_E*& line, size_t& length);
+
+	/**
+	 * Reads a block of raw data, ignoring lines and delimiters. Used for
+	 * binary data; lines cannot be read reliably afterwards.
+	 *
+	 * @param data
+	 *            the target of the data
+	 * @param count
+	 *            the number of characters to read
+	 * @return false if the real eof is reached before count characters were read
+	 */
+	bool readBlock(_E* data, size_t count);
+
 protected:
 	/**
-	 * Reads a character from the underlying stream.
+	 * Makes the rest of the current chunk available to the get area.
 	 *
 	 * @return the current character at the get pointer pos, if any; eof else
 	 */
 	virtual int_type underflow();
 
 private:
-	/** the wrapped stream buffer. */
-	std::basic_streambuf<_E, _Tr>& mStreamBuf;
+	/** Common part of the constructors. */
+	void init(const std::basic_string<_E>& delimiter);
+
+	/** Takes over the position of the get area, which istream reads may have advanced. */
+	void syncGetArea();
+
+	/** Empties the get area so that the next istream read calls underflow(). */
+	void resetGetArea();
+
+	/**
+	 * Reads the next block of data into the buffer, moving unread data to its
+	 * front and growing it if necessary.
+	 *
+	 * @return false if the real eof is reached
+	 */
+	bool fill();
+
+	/** Continues the search for the delimiter in the data read so far. */
+	void findDelimiter();
+
+	/** @return the end of the data that is known to belong to the current chunk */
+	inline size_t chunkLimit() const {
+		return mDelimiterFound ? mDelimiterPos : mScanned;
+	}
+
+	/** the wrapped stream buffer, if any. */
+	std::basic_streambuf<_E, _Tr>* mStreamBuf;
+	/** the file descriptor read from, if there is no stream buffer. */
+	int mFd;
 	/** the chunk seperation delimiter. */
 	_E *mDelimiter;
 	/** the delimiter length. */
 	size_t mDelimiterLen;
-	/** the input buffer. */
+	/** the input buffer; one character larger than its capacity for a final null. */
 	_E *mInBuf;
+	/** the capacity of the input buffer. */
+	size_t mCapacity;
+	/** offset of the first unread character. */
+	size_t mBegin;
+	/** offset behind the last character read. */
+	size_t mEnd;
+	/** offset up to which the data is known not to start a delimiter. */
+	size_t mScanned;
+	/** has a delimiter been found behind mBegin? */
+	bool mDelimiterFound;
+	/** offset of the delimiter found. */
+	size_t mDelimiterPos;
 	/** is the current chunk completed? */
 	bool mChunkCompleted;
 	/** has the stream really reached eof? */
 	bool mRealEof;
 };
 
+template<class _E, class _Tr>
+void ChunkStreamBuffer<_E, _Tr>::init(const std::basic_string<_E>& delimiter) {
+	assert(delimiter.size() > 0 && delimiter.size() < BUFF_SIZE);
+	mDelimiterLen = delimiter.size();
+	// copy the keyword
+	mDelimiter = new _E[mDelimiterLen];
+	_Tr::copy(mDelimiter, delimiter.c_str(), mDelimiterLen);
+	mCapacity = BUFF_SIZE;
+	mInBuf = new _E[mCapacity + 1];
+	mBegin = mEnd = mScanned = mDelimiterPos = 0;
+	mDelimiterFound = false;
+	mChunkCompleted = false;
+	mRealEof = false;
+	// initialize the get pointer
+	this->setg(0, 0, 0);
+}
+
+template<class _E, class _Tr>
+void ChunkStreamBuffer<_E, _Tr>::syncGetArea() {
+	if (this->gptr() != 0) {
+		mBegin = this->gptr() - mInBuf;
+	}
+}
+
+template<class _E, class _Tr>
+void ChunkStreamBuffer<_E, _Tr>::resetGetArea() {
+	this->setg(mInBuf + mBegin, mInBuf + mBegin, mInBuf + mBegin);
+}
+
+template<class _E, class _Tr>
+bool ChunkStreamBuffer<_E, _Tr>::fill() {
+	if (mRealEof) {
+		return false;
+	}
+	// move the unread data to the front of the buffer
+	if (mBegin > 0) {
+		_Tr::move(mInBuf, mInBuf + mBegin, mEnd - mBegin);
+		mEnd -= mBegin;
+		mScanned -= mBegin;
+		mBegin = 0;
+	}
+	// grow the buffer for lines longer than its capacity
+	if (mCapacity - mEnd < BUFF_SIZE / 2) {
+		size_t capacity = mCapacity * 2;
+		_E *buf = new _E[capacity + 1];
+		_Tr::copy(buf, mInBuf, mEnd);
+		delete[] mInBuf;
+		mInBuf = buf;
+		mCapacity = capacity;
+	}
+
+	std::streamsize len;
+	if (mStreamBuf != 0) {
+		// only request what is available without blocking, at least one character
+		std::streamsize avail = mStreamBuf->in_avail();
+		std::streamsize count = avail > 0 ? std::min<std::streamsize>(avail, mCapacity - mEnd) : 1;
+		len = mStreamBuf->sgetn(mInBuf + mEnd, count);
+	} else {
+		do {
+#ifdef _WIN32
+			len = _read(mFd, mInBuf + mEnd, (unsigned int) ((mCapacity - mEnd) * sizeof(_E)));
+#else
+			len = ::read(mFd, mInBuf + mEnd, (mCapacity - mEnd) * sizeof(_E));
+#endif
+		} while (len < 0 && errno == EINTR);
+		len = len > 0 ? len / sizeof(_E) : 0;
+	}
+	if (len <= 0) {
+		mRealEof = true;
+		return false;
+	}
+	mEnd += len;
+	return true;
+}
+
+template<class _E, class _Tr>
+void ChunkStreamBuffer<_E, _Tr>::findDelimiter() {
+	while (!mDelimiterFound && mScanned < mEnd) {
+		const _E *candidate = _Tr::find(mInBuf + mScanned, mEnd - mScanned, mDelimiter[0]);
+		if (candidate == 0) {
+			mScanned = mEnd;
+			return;
+		}
+		size_t pos = candidate - mInBuf;
+		size_t available = std::min(mDelimiterLen, mEnd - pos);
+		if (_Tr::compare(candidate, mDelimiter, available) != 0) {
+			// no delimiter, continue behind the candidate
+			mScanned = pos + 1;
+		} else if (available == mDelimiterLen) {
+			mScanned = pos;
+			mDelimiterPos = pos;
+			mDelimiterFound = true;
+		} else {
+			// a prefix of the delimiter at the end of the data; wait for more
+			mScanned = pos;
+			return;
+		}
+	}
+}
+
+template<class _E, class _Tr>
+bool ChunkStreamBuffer<_E, _Tr>::nextLine(_E*& line, size_t& length) {
+	syncGetArea();
+	while (!mChunkCompleted) {
+		findDelimiter();
+		size_t limit = chunkLimit();
+		const _E *lineBreak = mBegin < limit ? _Tr::find(mInBuf + mBegin, limit - mBegin, _Tr::to_char_type('\n')) : 0;
+		if (lineBreak != 0) {
+			line = mInBuf + mBegin;
+			length = lineBreak - line;
+			line[length] = _E();
+			mBegin += length + 1;
+			resetGetArea();
+			return true;
+		}
+		if (mDelimiterFound) {
+			// the chunk ends; the delimiter is consumed and may be overwritten
+			line = mInBuf + mBegin;
+			length = mDelimiterPos - mBegin;
+			line[length] = _E();
+			mBegin = mDelimiterPos + mDelimiterLen;
+			mScanned = mBegin;
+			mDelimiterFound = false;
+			mChunkCompleted = true;
+			resetGetArea();
+			return length > 0;
+		}
+		if (!fill()) {
+			// at eof, a trailing delimiter prefix is regular data
+			mScanned = mEnd;
+			mChunkCompleted = true;
+			if (mBegin == mEnd) {
+				resetGetArea();
+				return false;
+			}
+			line = mInBuf + mBegin;
+			length = mEnd - mBegin;
+			line[length] = _E();
+			mBegin = mEnd;
+			resetGetArea();
+			return true;
+		}
+	}
+	resetGetArea();
+	return false;
+}
+
+template<class _E, class _Tr>
+bool ChunkStreamBuffer<_E, _Tr>::readBlock(_E* data, size_t count) {
+	syncGetArea();
+	bool complete = true;
+	while (count > 0) {
+		size_t len = std::min(count, mEnd - mBegin);
+		_Tr::copy(data, mInBuf + mBegin, len);
+		data += len;
+		count -= len;
+		mBegin += len;
+		// forget the delimiter search, the data consumed may have contained anything
+		mScanned = mBegin;
+		mDelimiterFound = false;
+		if (count > 0 && !fill()) {
+			complete = false;
+			break;
+		}
+	}
+	resetGetArea();
+	return complete;
+}
+
 template<class _E, class _Tr>
 void ChunkStreamBuffer<_E, _Tr>::nextChunk() {
 	// read the rest of the chunk
-	int_type c = this->sbumpc();
-	while (!_Tr::eq_int_type(c, _Tr::eof())) {
-		c = this->sbumpc();
+	_E *line;
+	size_t length;
+	while (nextLine(line, length)) {
 	}
 	mChunkCompleted = false;
+	resetGetArea();
 }
 
 template<class _E, class _Tr>
 typename ChunkStreamBuffer<_E, _Tr>::int_type ChunkStreamBuffer<_E, _Tr>::underflow() {
-	if (mChunkCompleted || mRealEof) {
-		return _Tr::eof();
-	}
-	// read from the wrapped stream and search for the delimiter
-	_E *buf = mInBuf;
-	std::streamsize len = 0;
-	size_t curDelimiterPos = 0;
-	while (buf < mInBuf + BUFF_SIZE) {
-		int_type intc = mStreamBuf.sbumpc();
-		// eof reached?
-		if (_Tr::eq_int_type(intc, _Tr::eof())) {
-			mRealEof = true;
-			break;
+	syncGetArea();
+	while (!mChunkCompleted) {
+		findDelimiter();
+		size_t limit = chunkLimit();
+		if (mBegin < limit) {
+			this->setg(mInBuf + mBegin, mInBuf + mBegin, mInBuf + limit);
+			return _Tr::to_int_type(mInBuf[mBegin]);
 		}
-		_E c = _Tr::to_char_type(intc);
-		// match the read char with the current delimiter char
-		if (_Tr::eq(c, mDelimiter[curDelimiterPos])) {
-			++curDelimiterPos;
-			// complete delimiter found?
-			if (curDelimiterPos == mDelimiterLen) {
+		if (mDelimiterFound) {
+			mBegin = mDelimiterPos + mDelimiterLen;
+			mScanned = mBegin;
+			mDelimiterFound = false;
+			mChunkCompleted = true;
+		} else if (!fill()) {
+			mScanned = mEnd;
+			if (mBegin == mEnd) {
 				mChunkCompleted = true;
-				break;
 			}
-		} else {
-			// insert the prefix of the delimiter which was skipped so far
-			if (curDelimiterPos > 0) {
-				_Tr::copy(buf, mDelimiter, curDelimiterPos);
-				buf += curDelimiterPos;
-				len += curDelimiterPos;
-				curDelimiterPos = 0;
-			}
-			// write the current char into the buffer
-			*buf = c;
-			++buf;
-			++len;
 		}
 	}
-	this->setg(mInBuf, mInBuf, mInBuf + len);
-	// nothing read -> eof
-	if (len == 0) {
-		return _Tr::eof();
-	}
-	return _Tr::not_eof(mInBuf[0]);
+	resetGetArea();
+	return _Tr::eof();
 }
 
 template<class _E, class _Tr = std::char_traits<_E> >
@@ -172,8 +408,21 @@ public:
 	 */
 	explicit ChunkInputStream(std::basic_istream<_E, _Tr>& inputStream,
 			const std::basic_string<_E>& keyword) :
-		streamBuffer(*inputStream.rdbuf(), keyword),
-				std::basic_istream<_E, _Tr>(&streamBuffer) {
+		std::basic_istream<_E, _Tr>(0), streamBuffer(*inputStream.rdbuf(), keyword) {
+		this->init(&streamBuffer);
+	}
+
+	/**
+	 * Constructs the ChunkInputStream reading directly from a file descriptor.
+	 *
+	 * @param fd
+	 *            the file descriptor, e.g. 0 for stdin
+	 * @param keyword
+	 *            the keyword that seperates the chunks
+	 */
+	explicit ChunkInputStream(int fd, const std::basic_string<_E>& keyword) :
+		std::basic_istream<_E, _Tr>(0), streamBuffer(fd, keyword) {
+		this->init(&streamBuffer);
 	}
 
 	/**
@@ -193,6 +442,24 @@ public:
 		return streamBuffer.isRealEof();
 	}
 
+	/**
+	 * Takes the next line of the current chunk without copying it.
+	 *
+	 * @see ChunkStreamBuffer::nextLine
+	 */
+	inline bool nextLine(_E*& line, size_t& length) {
+		return streamBuffer.nextLine(line, length);
+	}
+
+	/**
+	 * Reads a block of raw data.
+	 *
+	 * @see ChunkStreamBuffer::readBlock
+	 */
+	inline bool readBlock(_E* data, size_t count) {
+		return streamBuffer.readBlock(data, count);
+	}
+
 private:
 	/** the chunk stream buffer. */
 	ChunkStreamBuffer<_E, _Tr> streamBuffer;
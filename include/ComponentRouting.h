@@ -0,0 +1,216 @@
+/**
+ * @file    ComponentRouting.h
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * Definition of the component router, which splits a graph into independent
+ * groups and routes each of them with its own router on its own thread. Two
+ * groups are independent if no edge connects them and their bounding boxes,
+ * enlarged by a spacing, do not overlap. As the work of libavoid grows
+ * superlinearly with the number of obstacles, several small routers are
+ * faster than one large router even on a single thread.
+ *
+ * Groups without edges are not routed at all. Routes can differ slightly from
+ * those of a single router if they would have left the enlarged bounding box
+ * of their group.
+ */
+#ifndef __COMPONENTROUTING_H__INCLUDED__
+#define __COMPONENTROUTING_H__INCLUDED__
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "libavoid/libavoid.h"
+#include "GraphRecords.h"
+#include "IdIndex.h"
+#include "LibavoidRouting.h"
+#include "RouterConfig.h"
+#include "RoutingControl.h"
+#include "SpatialGrid.h"
+
+/** Default spacing by which the bounding boxes of groups are enlarged. */
+const double DEFAULT_COMPONENT_SPACING = 50;
+
+/** Default margin around a viewport and the corridors of the edges. */
+const double DEFAULT_VIEWPORT_MARGIN = 100;
+
+/** Spacing that makes the whole graph one group. */
+const double NO_SPLIT = -1;
+
+/**
+ * The configuration that is applied to the router of each group.
+ */
+struct RouterSetup {
+    /** connector type of all edges. */
+    Avoid::ConnType connectorType;
+    /** layout direction used for port-less edges. */
+    std::string direction;
+    /** how pins of port-less edges are created. */
+    PinOptions pins;
+    /** the penalties and routing options. */
+    RouterConfig config;
+    /** should hyperedges be created from common sources? */
+    bool hyperedges;
+    /**
+     * should the routes only be approximated? Clusters, routing options and
+     * the penalties of crossings and shared paths are left out, and nothing
+     * after the route search is done, in particular no nudging.
+     */
+    bool coarse;
+};
+
+class ComponentRouter {
+public:
+    /**
+     * @param arena
+     *            the arena for the id index; null for the heap
+     */
+    explicit ComponentRouter(Arena* arena = NULL);
+
+    /**
+     * Prepares for the given number of elements.
+     */
+    void reserve(size_t nodes, size_t edges, size_t ports);
+
+    /** Deletes the routers of all groups. */
+    ~ComponentRouter();
+
+    /*
+     * Collecting the graph; the elements are added to the routers by route()
+     */
+    void addNode(const NodeRecord& node);
+
+    void addCluster(const ClusterRecord& cluster);
+
+    void addPort(const PortRecord& port);
+
+    /**
+     * @param fixedRoute
+     *            the route the connector of the edge is fixed to; null if it
+     *            is routed
+     */
+    void addEdge(const EdgeRecord& edge, const Avoid::PolyLine* fixedRoute = NULL);
+
+    /**
+     * Restricts the routing to the edges whose corridors, the boxes spanned by
+     * their end nodes, come within the margin of the viewport. Only the
+     * obstacles within the margin of these corridors are added to the router,
+     * and the graph is not split.
+     */
+    void setViewport(const Box& viewport, double margin);
+
+    /**
+     * Splits the graph into groups and routes them. Another call routes the
+     * same groups again, e.g. with another setup; the routers and connectors
+     * of the previous call are deleted.
+     *
+     * @param setup
+     *            the configuration of the routers
+     * @param spacing
+     *            the spacing by which the bounding boxes are enlarged, or
+     *            NO_SPLIT; only used by the first call
+     * @param threads
+     *            the maximum number of threads; 0 for the number of cores
+     * @param control
+     *            the control of the request; null for none
+     */
+    void route(const RouterSetup& setup, double spacing, unsigned int threads,
+            const RoutingControl* control = NULL);
+
+    /**
+     * Collects the connectors of all edges in the order in which the edges
+     * were added.
+     */
+    void result(std::vector<Avoid::ConnRef*>& cons) const;
+
+    /**
+     * Appends the hyperedges of the last call of route(), whose edges are not
+     * part of result().
+     */
+    void hyperedges(std::vector<Hyperedge>& hyperedges) const;
+
+    /** @return the number of groups that were routed */
+    size_t groupCount() const {
+        return mRouters.size();
+    }
+
+private:
+    /** A node or cluster, in the order in which they were added. */
+    struct Shape {
+        bool cluster;
+        /** index into mNodes or mClusters. */
+        size_t record;
+    };
+
+    /** A group of elements that is routed independently. */
+    struct Group {
+        /** indices into mShapes, ascending. */
+        std::vector<size_t> shapes;
+        /** indices into mPorts, ascending. */
+        std::vector<size_t> ports;
+        /** indices into mEdges, ascending. */
+        std::vector<size_t> edges;
+    };
+
+    /**
+     * @return the index into mShapes of the node with the given id, or -1
+     *         after reporting an error if there is none
+     */
+    size_t findNode(ElementId id) const;
+
+    /** Computes the independent groups that contain edges. */
+    void split(double spacing, std::vector<Group>& groups) const;
+
+    /** Puts all elements into one group. */
+    void wholeGraph(std::vector<Group>& groups) const;
+
+    /** Puts the elements needed for the viewport into one group. */
+    void clip(std::vector<Group>& groups) const;
+
+    /** @return the bounding box of a node or cluster */
+    Box shapeBox(size_t shape) const;
+
+    /** Creates the router of a group and routes it; appends its hyperedges. */
+    ControlledRouter* routeGroup(const Group& group, const RouterSetup& setup,
+            const RoutingControl* control, std::vector<Hyperedge>& hyperedges);
+
+    std::vector<NodeRecord> mNodes;
+    std::vector<ClusterRecord> mClusters;
+    std::vector<PortRecord> mPorts;
+    std::vector<EdgeRecord> mEdges;
+    /** the fixed routes by the indices into mEdges. */
+    std::unordered_map<size_t, Avoid::PolyLine> mFixedRoutes;
+    std::vector<Shape> mShapes;
+    /** the indices into mShapes by the ids of the nodes and clusters. */
+    IdIndex<size_t> mShapeIds;
+    /** is the routing restricted to a viewport? */
+    bool mClipped;
+    Box mViewport;
+    double mViewportMargin;
+    /** the groups; computed by the first call of route(). */
+    std::vector<Group> mGroups;
+    bool mGrouped;
+    /** the routers of the groups. */
+    std::vector<ControlledRouter*> mRouters;
+    /** the connector of each edge; null for invalid edges and the edges of hyperedges. */
+    std::vector<Avoid::ConnRef*> mConnectors;
+    /** the hyperedges of each group. */
+    std::vector<std::vector<Hyperedge> > mGroupHyperedges;
+
+    ComponentRouter(const ComponentRouter&);
+    ComponentRouter& operator=(const ComponentRouter&);
+};
+
+#endif
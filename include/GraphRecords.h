@@ -0,0 +1,82 @@
+/**
+ * @file    GraphRecords.h
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * Definition of the records describing the elements of an input graph. The
+ * records are filled by the protocol parsers and consumed by the functions
+ * that set up the router, so that the latter do not deal with text at all.
+ */
+#ifndef __GRAPHRECORDS_H__INCLUDED__
+#define __GRAPHRECORDS_H__INCLUDED__
+
+#include <stdint.h>
+
+/** Identifier of a node, cluster or port; any value chosen by the client. */
+typedef uint64_t ElementId;
+
+/** Side of a node a port is placed on. */
+enum PortSide {
+    SIDE_NORTH,
+    SIDE_EAST,
+    SIDE_SOUTH,
+    SIDE_WEST
+};
+
+/** A node: NODE {id} {x1} {y1} {x2} {y2} {incoming} {outgoing} */
+struct NodeRecord {
+    ElementId id;
+    double x1;
+    double y1;
+    double x2;
+    double y2;
+    /** number of incoming edges that are not connected to a port. */
+    int incoming;
+    /** number of outgoing edges that are not connected to a port. */
+    int outgoing;
+};
+
+/** A cluster: CLUSTER {id} {x1} {y1} {x2} {y2} */
+struct ClusterRecord {
+    ElementId id;
+    double x1;
+    double y1;
+    double x2;
+    double y2;
+};
+
+/** A port: PORT {port id} {node id} {side} {x} {y} */
+struct PortRecord {
+    ElementId id;
+    ElementId node;
+    PortSide side;
+    /** position of the port center relative to the node. */
+    double x;
+    double y;
+};
+
+/** An edge: {edge type} {edge id} {source node id} {target node id} {source port id} {target port id} */
+struct EdgeRecord {
+    unsigned int id;
+    ElementId source;
+    ElementId target;
+    /** is the edge connected to a port at its source (PEDGEP, PEDGE)? */
+    bool hasSourcePort;
+    /** is the edge connected to a port at its target (PEDGEP, EDGEP)? */
+    bool hasTargetPort;
+    ElementId sourcePort;
+    ElementId targetPort;
+};
+
+#endif
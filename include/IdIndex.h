@@ -0,0 +1,317 @@
+/**
+ * @file    IdIndex.h
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * Definition of an index that maps arbitrary 64-bit element ids to values in
+ * constant time. Clients usually number their elements densely, but native
+ * ids of a diagram editor can be sparse or huge.
+ *
+ * Ids below a limit are kept in a paged array whose pages are allocated on
+ * first use; all others are kept in an open addressing hash table with linear
+ * probing. The limit grows with the number of entries, so the array never
+ * holds more than a few slots per entry, however the ids are distributed.
+ * All memory is taken from an optional arena.
+ */
+#ifndef __IDINDEX_H__INCLUDED__
+#define __IDINDEX_H__INCLUDED__
+
+#include <cstddef>
+#include <vector>
+
+#include "GraphRecords.h"
+#include "Arena.h"
+
+template<typename T>
+class IdIndex {
+public:
+    /**
+     * @param arena
+     *            the arena to take memory from; null for the heap
+     */
+    explicit IdIndex(Arena* arena = NULL) :
+        mPages(PageAllocator(arena)), mTable(HashAllocator(arena)), mSize(0), mHashed(0),
+        mLimit(PAGE_SIZE) {
+    }
+
+    /**
+     * Prepares the index for ids up to the given count, which is how most
+     * clients number their elements.
+     */
+    void reserve(size_t count) {
+        if (count >= mLimit) {
+            raiseLimit((count + PAGE_SIZE) / PAGE_SIZE * PAGE_SIZE);
+        }
+        mPages.reserve(mLimit / PAGE_SIZE);
+    }
+
+    /**
+     * Adds a value.
+     *
+     * @return false if there already is a value with that id
+     */
+    bool insert(ElementId id, const T& value) {
+        if (id < mLimit) {
+            Page& page = densePage(id);
+            DenseSlot& slot = page[id % PAGE_SIZE];
+            if (slot.used) {
+                return false;
+            }
+            slot.value = value;
+            slot.used = true;
+        } else {
+            if (hashFind(id) != NULL) {
+                return false;
+            }
+            hashInsert(id, value);
+        }
+        ++mSize;
+        widen();
+        return true;
+    }
+
+    /**
+     * @return the value with the given id, or null if there is none
+     */
+    T* find(ElementId id) {
+        if (id < mLimit) {
+            size_t page = id / PAGE_SIZE;
+            if (page >= mPages.size() || mPages[page].empty()) {
+                return NULL;
+            }
+            DenseSlot& slot = mPages[page][id % PAGE_SIZE];
+            return slot.used ? &slot.value : NULL;
+        }
+        return hashFind(id);
+    }
+
+    const T* find(ElementId id) const {
+        return const_cast<IdIndex*>(this)->find(id);
+    }
+
+    /**
+     * Removes a value.
+     *
+     * @return false if there was no value with that id
+     */
+    bool erase(ElementId id) {
+        if (id < mLimit) {
+            T* value = find(id);
+            if (value == NULL) {
+                return false;
+            }
+            DenseSlot& slot = mPages[id / PAGE_SIZE][id % PAGE_SIZE];
+            slot.value = T();
+            slot.used = false;
+        } else if (!hashErase(id)) {
+            return false;
+        }
+        --mSize;
+        return true;
+    }
+
+    /**
+     * Calls fn(id, value) for every value, in no particular order. The index
+     * must not be modified meanwhile.
+     */
+    template<typename Fn>
+    void forEach(Fn fn) const {
+        for (size_t p = 0; p < mPages.size(); ++p) {
+            for (size_t i = 0; i < mPages[p].size(); ++i) {
+                if (mPages[p][i].used) {
+                    fn((ElementId) (p * PAGE_SIZE + i), mPages[p][i].value);
+                }
+            }
+        }
+        for (size_t i = 0; i < mTable.size(); ++i) {
+            if (mTable[i].used) {
+                fn(mTable[i].id, mTable[i].value);
+            }
+        }
+    }
+
+    size_t size() const {
+        return mSize;
+    }
+
+    void clear() {
+        mPages.clear();
+        mTable.clear();
+        mSize = 0;
+        mHashed = 0;
+        mLimit = PAGE_SIZE;
+    }
+
+private:
+    /** Number of slots of a page of the array. */
+    static const size_t PAGE_SIZE = 1024;
+    /** The array covers ids below this many times the number of entries. */
+    static const size_t DENSITY = 4;
+
+    struct DenseSlot {
+        T value;
+        bool used;
+
+        DenseSlot() :
+            value(), used(false) {
+        }
+    };
+
+    struct HashSlot {
+        ElementId id;
+        T value;
+        bool used;
+
+        HashSlot() :
+            id(0), value(), used(false) {
+        }
+    };
+
+    typedef std::vector<DenseSlot, ArenaAllocator<DenseSlot> > Page;
+    typedef ArenaAllocator<Page> PageAllocator;
+    typedef ArenaAllocator<HashSlot> HashAllocator;
+    typedef std::vector<HashSlot, HashAllocator> HashTable;
+
+    Page& densePage(ElementId id) {
+        size_t page = id / PAGE_SIZE;
+        if (page >= mPages.size()) {
+            mPages.resize(page + 1, Page(ArenaAllocator<DenseSlot>(mPages.get_allocator())));
+        }
+        if (mPages[page].empty()) {
+            mPages[page].resize(PAGE_SIZE);
+        }
+        return mPages[page];
+    }
+
+    /**
+     * Raises the limit of the array once the entries would fill it densely
+     * enough, moving hashed entries below the new limit into the array. The
+     * limit at least doubles, so each entry is moved a logarithmic number of
+     * times at most.
+     */
+    void widen() {
+        if (mSize * DENSITY >= mLimit * 2) {
+            raiseLimit((mSize * DENSITY + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE);
+        }
+    }
+
+    void raiseLimit(ElementId limit) {
+        mLimit = limit;
+        if (mHashed == 0) {
+            return;
+        }
+        HashTable table(mTable.get_allocator());
+        table.swap(mTable);
+        mHashed = 0;
+        for (size_t i = 0; i < table.size(); ++i) {
+            if (!table[i].used) {
+                continue;
+            }
+            if (table[i].id < mLimit) {
+                DenseSlot& slot = densePage(table[i].id)[table[i].id % PAGE_SIZE];
+                slot.value = table[i].value;
+                slot.used = true;
+            } else {
+                hashInsert(table[i].id, table[i].value);
+            }
+        }
+    }
+
+    static size_t hash(ElementId id) {
+        // the finalizer of splitmix64
+        id ^= id >> 30;
+        id *= 0xbf58476d1ce4e5b9ULL;
+        id ^= id >> 27;
+        id *= 0x94d049bb133111ebULL;
+        id ^= id >> 31;
+        return (size_t) id;
+    }
+
+    T* hashFind(ElementId id) {
+        if (mHashed == 0) {
+            return NULL;
+        }
+        size_t mask = mTable.size() - 1;
+        for (size_t i = hash(id) & mask; mTable[i].used; i = (i + 1) & mask) {
+            if (mTable[i].id == id) {
+                return &mTable[i].value;
+            }
+        }
+        return NULL;
+    }
+
+    void hashInsert(ElementId id, const T& value) {
+        // the table is kept at most half full
+        if ((mHashed + 1) * 2 > mTable.size()) {
+            HashTable table(mTable.empty() ? 16 : mTable.size() * 2, HashSlot(),
+                    mTable.get_allocator());
+            table.swap(mTable);
+            mHashed = 0;
+            for (size_t i = 0; i < table.size(); ++i) {
+                if (table[i].used) {
+                    hashInsert(table[i].id, table[i].value);
+                }
+            }
+        }
+        size_t mask = mTable.size() - 1;
+        size_t i = hash(id) & mask;
+        while (mTable[i].used) {
+            i = (i + 1) & mask;
+        }
+        mTable[i].id = id;
+        mTable[i].value = value;
+        mTable[i].used = true;
+        ++mHashed;
+    }
+
+    bool hashErase(ElementId id) {
+        if (mHashed == 0) {
+            return false;
+        }
+        size_t mask = mTable.size() - 1;
+        size_t i = hash(id) & mask;
+        while (mTable[i].used && mTable[i].id != id) {
+            i = (i + 1) & mask;
+        }
+        if (!mTable[i].used) {
+            return false;
+        }
+        // shift following entries back, so that no probe sequence is interrupted
+        size_t gap = i;
+        for (size_t j = (i + 1) & mask; mTable[j].used; j = (j + 1) & mask) {
+            size_t home = hash(mTable[j].id) & mask;
+            // move the entry unless its home lies cyclically in (gap, j]
+            bool between = gap <= j ? (gap < home && home <= j) : (gap < home || home <= j);
+            if (!between) {
+                mTable[gap] = mTable[j];
+                gap = j;
+            }
+        }
+        mTable[gap] = HashSlot();
+        --mHashed;
+        return true;
+    }
+
+    /** the pages of the array; unused pages are empty. */
+    std::vector<Page, PageAllocator> mPages;
+    /** the hash table; its size is zero or a power of two. */
+    HashTable mTable;
+    size_t mSize;
+    /** number of entries in the hash table. */
+    size_t mHashed;
+    /** ids below the limit are kept in the array. */
+    ElementId mLimit;
+};
+
+#endif
@@ -0,0 +1,165 @@
+/**
+ * @file    LayoutWriter.h
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * Definition of the layout writer, which formats the routes of a response into
+ * a reusable buffer. The buffer is handed to the output stream in one piece at
+ * the end of the response, or earlier whenever it exceeds the high-water mark,
+ * so that the client can start reading the first edges of large responses.
+ *
+ * Coordinates are written in the shortest form that reads back to the same
+ * double, or rounded to a given number of decimals. The edges of large
+ * responses are formatted by several threads, each into a buffer of its own,
+ * and the buffers are emitted in the order of the edges.
+ */
+#ifndef __LAYOUTWRITER_H__INCLUDED__
+#define __LAYOUTWRITER_H__INCLUDED__
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "libavoid/libavoid.h"
+#include "RoutingControl.h"
+
+/**
+ * The route of a net of edges that share their source, as a tree of segments
+ * that meet in junctions.
+ */
+struct Hyperedge {
+    /** the ids of the edges of the net. */
+    std::vector<unsigned int> edges;
+    /** the segments between the terminals and junctions. */
+    std::vector<Avoid::PolyLine> segments;
+};
+
+/** Default number of buffered bytes after which a response is emitted early. */
+const size_t DEFAULT_HIGH_WATER_MARK = 1 << 20;
+
+/** Precision of coordinates that are written in the shortest exact form. */
+const int EXACT_PRECISION = -1;
+
+/** The largest number of decimals coordinates can be rounded to. */
+const int MAX_PRECISION = 9;
+
+/** The least number of edges formatted by each thread of a response. */
+const size_t MIN_EDGES_PER_THREAD = 4096;
+
+class LayoutWriter {
+public:
+    /**
+     * Constructs the writer.
+     *
+     * @param highWaterMark
+     *            number of buffered bytes after which the buffer is emitted
+     *            before the response is complete; 0 to emit only complete
+     *            responses
+     */
+    explicit LayoutWriter(size_t highWaterMark = DEFAULT_HIGH_WATER_MARK);
+
+    void setHighWaterMark(size_t highWaterMark) {
+        mHighWaterMark = highWaterMark;
+    }
+
+    /**
+     * Sets the number of decimals coordinates are rounded to, at most
+     * MAX_PRECISION; trailing zeros are left out. EXACT_PRECISION writes
+     * them exactly.
+     */
+    void setPrecision(int precision) {
+        mPrecision = precision;
+    }
+
+    /**
+     * Writes the routes of the connectors as LAYOUT response and flushes
+     * the output stream. With a report, its fallback routes are written and
+     * each edge is followed by the state of its route: EDGE {id} {state}=...
+     * Hyperedges follow the edges as HYPEREDGE {ids}={segment}| {segment}...
+     *
+     * @return the number of bytes written
+     */
+    size_t write(std::ostream& out, const std::vector<Avoid::ConnRef*>& cons,
+            const RouteReport* report = NULL, const std::vector<Hyperedge>* hyperedges = NULL);
+
+    /**
+     * Appends the HYPEREDGE line of a hyperedge.
+     */
+    void appendHyperedge(const Hyperedge& hyperedge);
+
+    /** Appends the points of a route. */
+    void appendRoute(const Avoid::PolyLine& route);
+
+    /** @return the text appended so far */
+    std::string text() const {
+        return std::string(mBuffer.begin(), mBuffer.end());
+    }
+
+    /**
+     * Appends the shortest decimal representation of the value that reads
+     * back to the same double, or the value rounded to the precision.
+     */
+    void appendDouble(double value);
+
+    void appendUnsigned(unsigned long value);
+
+    void append(const char* text, size_t length);
+
+private:
+    /** Hands the buffered text to the output stream. */
+    void emit(std::ostream& out, bool flush);
+
+    /** Appends a decimal given by its digits and the number of them after the point. */
+    void appendDecimal(unsigned long long digits, int decimals, bool negative);
+
+    /** Appends the EDGE line of a connector of the result. */
+    void appendEdge(const std::vector<Avoid::ConnRef*>& cons, const RouteReport* report,
+            size_t i);
+
+    /** Appends the EDGE lines of a range of connectors. */
+    void appendEdges(const std::vector<Avoid::ConnRef*>& cons, const RouteReport* report,
+            size_t begin, size_t end);
+
+    /**
+     * Writes the EDGE lines, formatted by several threads, and emits the
+     * buffer whenever it exceeds the high-water mark.
+     *
+     * @return the number of bytes emitted
+     */
+    size_t writeEdgesConcurrently(std::ostream& out, const std::vector<Avoid::ConnRef*>& cons,
+            const RouteReport* report, unsigned int threads);
+
+    /** the buffer, which keeps its capacity between responses. */
+    std::vector<char> mBuffer;
+    /** number of bytes after which the buffer is emitted early. */
+    size_t mHighWaterMark;
+    /** number of decimals of the coordinates. */
+    int mPrecision;
+};
+
+/**
+ * Writing the graph to the output stream; uses one writer per thread.
+ * Returns the number of bytes written
+ */
+size_t writeLayout(std::ostream& out, const std::vector<Avoid::ConnRef*>& cons,
+        const RouteReport* report = NULL, const std::vector<Hyperedge>* hyperedges = NULL,
+        int precision = EXACT_PRECISION);
+
+/**
+ * Sets the high-water mark used by writeLayout for all threads; must be called
+ * before the first response is written.
+ */
+void setLayoutHighWaterMark(size_t highWaterMark);
+
+#endif
@@ -18,19 +18,23 @@
  * connector routing as well as to write the results back to an output stream.
  *
  * Protocol:
- *  - All nodes are passed together with a continuously increasing id starting by 1. (1 2 3 4 ...) 
- *  - The same goes for the edges. 
+ *  - Nodes, clusters and ports may carry arbitrary 64-bit ids; they are
+ *    resolved through the GraphIndex of the graph.
+ *  - Edges are reported with the id they were passed with.
  */
+#ifndef __LIBAVOIDROUTING_H__INCLUDED__
+#define __LIBAVOIDROUTING_H__INCLUDED__
+
 #include <iostream>
 #include <string>
-#include <sstream>
+#include <vector>
+#include <unordered_map>
 
 #include "libavoid/libavoid.h"
-
-/*
- * Debug
- */
-//#define DEBUG_EXEC_TIME
+#include "GraphRecords.h"
+#include "IdIndex.h"
+#include "LineParser.h"
+#include "LayoutWriter.h"
 
 /*
  * Edge Routing
@@ -46,6 +50,15 @@
 #define DIRECTION_DOWN              "DOWN"
 #define DIRECTION_LEFT              "LEFT"
 
+/*
+ * Pins of port-less edges
+ */
+#define PIN_STRATEGY                "pinStrategy"
+#define PIN_STRATEGY_EXCLUSIVE      "EXCLUSIVE"
+#define PIN_STRATEGY_SHARED         "SHARED"
+#define PIN_STRATEGY_CAPPED         "CAPPED"
+#define PIN_SLOTS                   "pinSlots"
+
 /*
  * Routing Penalties
  */
@@ -70,6 +83,12 @@
 #define IMPROVE_HYPEREDGES_ADD_DELETE           "improveHyperedgeRoutesMovingAddingAndDeletingJunctions"
 #define NUDGE_SHARED_PATHS_COMMON_ENDPOINT      "nudgeSharedPathsWithCommonEndPoint"
 #define ENABLE_HYPEREDGES_FROM_COMMON_SOURCE     "enableHyperedgesFromCommonSource"
+#define SPLIT_COMPONENTS                        "splitComponents"
+#define COMPONENT_SPACING                       "componentSpacing"
+#define TIME_LIMIT_MS                           "timeLimitMs"
+#define PROGRESSIVE                             "progressive"
+#define MEMORY_LIMIT_MB                         "memoryLimitMb"
+#define COORDINATE_PRECISION                    "coordinatePrecision"
 
 /*
  * Port Sides 
@@ -82,8 +101,8 @@
 /*
  * Pin Types
  *
- * Per definition the ids of passed ports start at 5. Thus, [1..4] are free for
- * arbitrary definition.
+ * Ports get pin class ids from 5 onwards in the order they are added, so that
+ * [1..4] are free for arbitrary definition whatever the ids of the ports are.
  */
 /** Indicates pins that can be used by an arbitrary endpoint of an edge. */
 const unsigned int PIN_ARBITRARY = 1;
@@ -91,55 +110,139 @@ const unsigned int PIN_ARBITRARY = 1;
 const unsigned int PIN_INCOMING = 2;
 /** Indicates pins reserved for outgoing edges. */
 const unsigned int PIN_OUTGOING = 3;
+/** The pin class id of the first port. */
+const unsigned int FIRST_PORT_PIN = 5;
 
 /**
- * Assembling the graph
+ * How the pins of port-less edges are created. With EXCLUSIVE, every edge
+ * gets its own pin on each candidate side, which makes a node with n edges
+ * carry up to 4n pins. SHARED creates a single pin per side that all edges
+ * use; libavoid's nudging separates the routes afterwards. CAPPED creates at
+ * most a given number of pins per side, which are shared if there are more
+ * edges than pins.
  */
-void setPenalty(std::string optionId, std::string token, Avoid::Router* router);
-
-void setOption(std::string optionId, std::string token, Avoid::Router* router);
-
-void addNode(std::vector<std::string> &tokens, std::vector<Avoid::ShapeRef*> &shapes,
-        Avoid::Router* router, std::string direction);
+enum PinStrategy {
+    PINS_EXCLUSIVE,
+    PINS_SHARED,
+    PINS_CAPPED
+};
 
-void addCluster(std::vector<std::string> &tokens, std::vector<Avoid::ShapeRef*> &shapes, Avoid::Router* router);
+/** Default number of pins per side for PINS_CAPPED. */
+const unsigned int DEFAULT_PIN_SLOTS = 4;
 
-void addPort(std::vector<std::string> &tokens, std::vector<Avoid::ShapeConnectionPin*> &pins,
-        std::vector<Avoid::ShapeRef*> &shapes, Avoid::Router* router);
+struct PinOptions {
+    PinStrategy strategy;
+    /** maximum number of pins per side for PINS_CAPPED. */
+    unsigned int slots;
 
-void addEdge(std::vector<std::string> &tokens, Avoid::ConnType connectorType,
-        std::vector<Avoid::ShapeRef*> &shapes, std::vector<Avoid::ConnRef*> &cons,
-        Avoid::Router* router, std::string direction);
+    PinOptions() :
+        strategy(PINS_EXCLUSIVE), slots(DEFAULT_PIN_SLOTS) {
+    }
+};
 
-void createHyperedges(std::vector<Avoid::ConnRef*> &cons, Avoid::Router* router);
+/**
+ * The pin of a port together with the node it belongs to.
+ */
+struct PortPin {
+    Avoid::ShapeRef* shape;
+    /** the pin class id used to connect edges to the port. */
+    unsigned int pinClass;
+};
 
 /**
- * Writing the graph to the output stream
+ * The elements of a graph, indexed by the ids they were passed with.
  */
-void writeLayout(std::ostream& out, std::vector<Avoid::ConnRef*> cons);
+struct GraphIndex {
+    IdIndex<Avoid::ShapeRef*> nodes;
+    IdIndex<Avoid::ClusterRef*> clusters;
+    IdIndex<PortPin> ports;
+    /** the pin class id of the next port. */
+    unsigned int nextPinClass;
+
+    /**
+     * @param arena
+     *            the arena to take memory from; null for the heap
+     */
+    explicit GraphIndex(Arena* arena = NULL) :
+        nodes(arena), clusters(arena), ports(arena),
+        nextPinClass(FIRST_PORT_PIN) {
+    }
+};
 
-/*
- * Convenient methods
+/**
+ * Resolves a penalty id, with or without the KIELER prefix.
+ *
+ * @return false after reporting an error if the id is unknown
  */
-inline double toDouble(std::string const& s) {
-    std::istringstream i(s);
-    double x;
-    i >> x;
+bool findPenalty(const char* optionId, Avoid::RoutingParameter& parameter);
 
-    return x;
-}
+/**
+ * Resolves a routing option id, with or without the KIELER prefix.
+ *
+ * @return false after reporting an error if the id is unknown
+ */
+bool findRoutingOption(const char* optionId, Avoid::RoutingOption& option);
 
-inline int toInt(std::string const& s) {
-    std::istringstream i(s);
-    int x;
-    i >> x;
+/**
+ * Assembling the graph
+ */
+void addNode(const NodeRecord& node, GraphIndex& index, Avoid::Router* router,
+        const std::string& direction, const PinOptions& pins);
 
-    return x;
-}
+void addCluster(const ClusterRecord& cluster, GraphIndex& index, Avoid::Router* router);
 
-inline bool toBool(std::string const& s) {
-    return (s == "true" || s == "TRUE" || s == "True");
-}
+void addPort(const PortRecord& port, GraphIndex& index, Avoid::Router* router);
 
-void tokenize(std::string text, std::vector<std::string>& tokens);
+/**
+ * Creates the connector of an edge and appends it to cons.
+ *
+ * @return the connector, or null if the edge refers to an unknown node or port
+ */
+Avoid::ConnRef* addEdge(const EdgeRecord& edge, Avoid::ConnType connectorType, GraphIndex& index,
+        std::vector<Avoid::ConnRef*> &cons, Avoid::Router* router, const std::string& direction);
 
+/**
+ * Collects the edges that leave the same port while the graph is read, so
+ * that each net of several edges is registered with libavoid's hyperedge
+ * rerouter before the transaction and routed as one tree of junctions and
+ * shared segments in it. Only orthogonal edges are routed as hyperedges.
+ */
+class HyperedgeCollector {
+public:
+    /**
+     * @return false if the edge has no source port; it has to be added as a
+     *         connector then
+     */
+    bool add(const EdgeRecord& edge);
+
+    /**
+     * Adds the collected edges to the router before the transaction: nets of
+     * a single edge as connectors, which are appended to cons, all others as
+     * hyperedges.
+     */
+    void addToRouter(Avoid::ConnType connectorType, GraphIndex& index,
+            std::vector<Avoid::ConnRef*>& cons, Avoid::Router* router,
+            const std::string& direction);
+
+    /**
+     * Appends the trees of the hyperedges after the transaction.
+     */
+    void result(Avoid::Router* router, std::vector<Hyperedge>& hyperedges) const;
+
+private:
+    /** A net that has been registered with the hyperedge rerouter. */
+    struct RegisteredNet {
+        /** the index returned by the rerouter. */
+        size_t index;
+        /** the common source, followed by the targets of the edges. */
+        Avoid::ConnEndList terminals;
+        std::vector<EdgeRecord> edges;
+    };
+
+    /** the edges of each source port, in the order the ports were first used. */
+    std::vector<std::vector<EdgeRecord> > mNets;
+    std::unordered_map<ElementId, size_t> mNetOfPort;
+    std::vector<RegisteredNet> mRegistered;
+};
+
+#endif
@@ -0,0 +1,216 @@
+/**
+ * @file    LineParser.h
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * Definition of the parser for the lines of the text protocol. A line is split
+ * into tokens in place: the separators following the tokens are overwritten
+ * with null characters and the tokens point into the line itself. Together with
+ * a reused token vector this makes parsing free of heap allocations once the
+ * buffers have grown to the size of the longest line.
+ *
+ * The first token of a line is resolved to a command using a precomputed
+ * keyword table, so the request handler can dispatch with a single switch.
+ */
+#ifndef __LINEPARSER_H__INCLUDED__
+#define __LINEPARSER_H__INCLUDED__
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "GraphRecords.h"
+
+/** The commands of the text protocol. */
+enum Command {
+    CMD_UNKNOWN,
+    CMD_ADD,
+    CMD_BATCH,
+    CMD_CACHESTATS,
+    CMD_CANCEL,
+    CMD_CLUSTER,
+    CMD_COMMENT,
+    CMD_DEBUG,
+    CMD_EDGE,
+    CMD_EDGEP,
+    CMD_FIXED,
+    CMD_GRAPH,
+    CMD_GRAPHEND,
+    CMD_MOVE,
+    CMD_NODE,
+    CMD_OPTION,
+    CMD_PEDGE,
+    CMD_PEDGEP,
+    CMD_PENALTY,
+    CMD_PORT,
+    CMD_PROFILE,
+    CMD_REMOVE,
+    CMD_REQUEST,
+    CMD_RESIZE,
+    CMD_ROUTE,
+    CMD_ROUTINGOPTION,
+    CMD_SESSION,
+    CMD_SESSIONEND,
+    CMD_SHARED,
+    CMD_STATS,
+    CMD_VIEWPORT
+};
+
+/**
+ * Resolves a keyword to its command.
+ *
+ * @return the command, or CMD_UNKNOWN if the keyword is none
+ */
+Command lookupCommand(const char* keyword);
+
+class LineParser {
+public:
+    LineParser() :
+        mFirst(0), mCommand(CMD_UNKNOWN) {
+    }
+
+    /**
+     * Splits a line into tokens in place. The tokens stay valid until the line
+     * is modified or the next line is parsed.
+     *
+     * @param line
+     *            the line, which is modified
+     * @param length
+     *            the length of the line
+     * @return the number of tokens
+     */
+    size_t parse(char* line, size_t length);
+
+    inline size_t parse(std::string& line) {
+        return parse(&line[0], line.size());
+    }
+
+    /**
+     * Drops the first token and resolves the following one as command.
+     */
+    void shift();
+
+    /**
+     * Drops the tokens behind the given number of tokens.
+     */
+    void truncate(size_t size);
+
+    /**
+     * @return the command given by the first token
+     */
+    inline Command command() const {
+        return mCommand;
+    }
+
+    /**
+     * @return the number of tokens
+     */
+    inline size_t size() const {
+        return mTokens.size() - mFirst;
+    }
+
+    inline bool empty() const {
+        return size() == 0;
+    }
+
+    /**
+     * @return the token at the given index as null-terminated string
+     */
+    inline const char* operator[](size_t i) const {
+        return mTokens[mFirst + i];
+    }
+
+private:
+    /** the tokens of the current line; reused for all lines. */
+    std::vector<const char*> mTokens;
+    /** index of the first token that has not been dropped. */
+    size_t mFirst;
+    /** command of the current line. */
+    Command mCommand;
+};
+
+/**
+ * A source of lines that are handed out in place, without copying.
+ */
+class LineSource {
+public:
+    virtual ~LineSource() {
+    }
+
+    /**
+     * Takes the next line. The line is null-terminated, does not contain the
+     * line break, and stays valid until the next call.
+     *
+     * @return false if there are no more lines
+     */
+    virtual bool nextLine(char*& line, size_t& length) = 0;
+};
+
+/**
+ * Hands out the lines of a string, which is modified in place.
+ */
+class StringLineSource: public LineSource {
+public:
+    explicit StringLineSource(std::string& text) :
+        mText(text), mPos(0) {
+    }
+
+    virtual bool nextLine(char*& line, size_t& length);
+
+private:
+    std::string& mText;
+    size_t mPos;
+};
+
+/**
+ * Hands out the lines of a buffer that ends with a line break, e.g. in shared
+ * memory; the buffer is modified in place.
+ */
+class BufferLineSource: public LineSource {
+public:
+    BufferLineSource(char* data, size_t length) :
+        mData(data), mEnd(data + length) {
+    }
+
+    virtual bool nextLine(char*& line, size_t& length);
+
+private:
+    char* mData;
+    char* mEnd;
+};
+
+/*
+ * Conversion of tokens to records; each returns false if the line has an
+ * invalid format
+ */
+bool parseNode(const LineParser& line, NodeRecord& node);
+
+bool parseCluster(const LineParser& line, ClusterRecord& cluster);
+
+bool parsePort(const LineParser& line, PortRecord& port);
+
+bool parseEdge(const LineParser& line, EdgeRecord& edge);
+
+/*
+ * Convenient methods
+ */
+double toDouble(const char* s);
+
+int toInt(const char* s);
+
+ElementId toId(const char* s);
+
+bool toBool(const char* s);
+
+#endif
@@ -0,0 +1,92 @@
+/**
+ * @file    MemoryMeter.h
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * Definition of the memory accounting of requests. The program replaces the
+ * global operator new and delete, which count the bytes of each allocation
+ * towards the meter of the calling thread, if it has one. A request installs
+ * its meter on all threads that work for it, so that the meter sees what its
+ * router allocates, in particular the visibility graph built by libavoid.
+ * Memory that is allocated by one request and released by another, e.g. the
+ * graph of a session, is counted where it happens; the meter only measures
+ * the change during the request.
+ */
+#ifndef __MEMORYMETER_H__INCLUDED__
+#define __MEMORYMETER_H__INCLUDED__
+
+#include <atomic>
+#include <cstddef>
+#include <stdint.h>
+
+class MemoryMeter {
+public:
+    MemoryMeter() :
+        mCurrent(0), mPeak(0) {
+    }
+
+    void allocated(size_t bytes) {
+        int64_t current = mCurrent += (int64_t) bytes;
+        int64_t peak = mPeak.load(std::memory_order_relaxed);
+        while (current > peak && !mPeak.compare_exchange_weak(peak, current)) {
+        }
+    }
+
+    void released(size_t bytes) {
+        mCurrent -= (int64_t) bytes;
+    }
+
+    /** @return the bytes allocated and not released since the meter was created */
+    int64_t current() const {
+        return mCurrent;
+    }
+
+    /** @return the highest value of current() so far */
+    int64_t peak() const {
+        return mPeak;
+    }
+
+private:
+    std::atomic<int64_t> mCurrent;
+    std::atomic<int64_t> mPeak;
+
+    MemoryMeter(const MemoryMeter&);
+    MemoryMeter& operator=(const MemoryMeter&);
+};
+
+/**
+ * Counts the allocations of the calling thread towards a meter until its
+ * destruction, which restores the previous meter.
+ */
+class MemoryScope {
+public:
+    /**
+     * @param meter
+     *            the meter; null to stop counting
+     */
+    explicit MemoryScope(MemoryMeter* meter);
+
+    ~MemoryScope();
+
+private:
+    MemoryMeter* mPrevious;
+
+    MemoryScope(const MemoryScope&);
+    MemoryScope& operator=(const MemoryScope&);
+};
+
+/** @return the meter of the calling thread, or null */
+MemoryMeter* threadMemoryMeter();
+
+#endif
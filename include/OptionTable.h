@@ -0,0 +1,61 @@
+/**
+ * @file    OptionTable.h
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * Definition of the lookup of option ids. All ids of the PENALTY,
+ * ROUTINGOPTION and OPTION lines, including their prefixed variants, are kept
+ * in one constant table together with the libavoid enum or layout option they
+ * stand for. The table is arranged into a perfect hash at compile time, so an
+ * id is resolved by hashing it once and comparing it to a single entry.
+ */
+#ifndef __OPTIONTABLE_H__INCLUDED__
+#define __OPTIONTABLE_H__INCLUDED__
+
+/** The lines an option id may be given in. */
+enum OptionKind {
+    /** PENALTY; the value is an Avoid::RoutingParameter. */
+    OPTION_PENALTY,
+    /** ROUTINGOPTION; the value is an Avoid::RoutingOption. */
+    OPTION_ROUTING,
+    /** OPTION; the value is a LayoutOption. */
+    OPTION_LAYOUT
+};
+
+/** The options of OPTION lines. */
+enum LayoutOption {
+    LAYOUT_EDGE_ROUTING,
+    LAYOUT_DIRECTION,
+    LAYOUT_PIN_STRATEGY,
+    LAYOUT_PIN_SLOTS,
+    LAYOUT_HYPEREDGES,
+    LAYOUT_SPLIT_COMPONENTS,
+    LAYOUT_COMPONENT_SPACING,
+    LAYOUT_TIME_LIMIT,
+    LAYOUT_PROGRESSIVE,
+    LAYOUT_MEMORY_LIMIT,
+    LAYOUT_COORDINATE_PRECISION,
+    LAYOUT_OPTION_COUNT
+};
+
+/**
+ * Resolves an option id, with or without one of the prefixes of its kind.
+ *
+ * @param value
+ *            set to the enum value of the option
+ * @return false if the id is not an option of the given kind
+ */
+bool findOption(OptionKind kind, const char* optionId, int& value);
+
+#endif
@@ -0,0 +1,45 @@
+/**
+ * @file    Prefork.h
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * Definition of the prefork mode. A supervisor process listens on a Unix
+ * domain socket and forks a number of workers once it is set up. Each worker
+ * accepts one connection at a time and serves it like the standard input of a
+ * single server process, so a client that connects finds a process that is
+ * started, initialized and has routed before. Workers that exit are replaced.
+ * Not available on Windows.
+ */
+#ifndef __PREFORK_H__INCLUDED__
+#define __PREFORK_H__INCLUDED__
+
+#include <string>
+
+#include "SocketServer.h"
+
+/**
+ * Runs the supervisor until it receives SIGINT or SIGTERM, which also ends the
+ * workers.
+ *
+ * @param socketPath
+ *            the path of the socket, which is replaced if it exists
+ * @param workers
+ *            the number of worker processes
+ * @param serve
+ *            serves a connection in a worker
+ * @return the exit code of the supervisor
+ */
+int runPrefork(const std::string& socketPath, unsigned int workers, ConnectionHandler serve);
+
+#endif
@@ -0,0 +1,142 @@
+/**
+ * @file    RequestPool.h
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * Definition of the request pool, which handles requests concurrently. Each
+ * worker thread creates its own routers, as libavoid routers share no global
+ * state. Responses are tagged with the id of their request and written in the
+ * order in which they are completed.
+ *
+ * Requests of the same named session are always handled by the same worker, so
+ * they are applied in the order in which they were received.
+ */
+#ifndef __REQUESTPOOL_H__INCLUDED__
+#define __REQUESTPOOL_H__INCLUDED__
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "LineParser.h"
+#include "RouterSession.h"
+
+/** The function that handles a single request. */
+typedef void (*RequestHandler)(LineSource& in, std::ostream& out, SessionMap& sessions);
+
+class RequestPool {
+public:
+    /**
+     * Constructs the pool and starts its threads.
+     *
+     * @param handler
+     *            the function that handles a single request
+     * @param workers
+     *            the number of worker threads
+     * @param out
+     *            the output stream the responses are written to
+     */
+    RequestPool(RequestHandler handler, unsigned int workers, std::ostream& out);
+
+    /**
+     * Waits for all submitted requests to be handled and stops the threads.
+     */
+    ~RequestPool();
+
+    /**
+     * Queues a request for handling.
+     *
+     * @param request
+     *            the complete text of the request, without chunk delimiter
+     */
+    void submit(std::string request);
+
+    /**
+     * Cancels the queued and running requests with the given id, or all of
+     * them if the id is empty. Cancelled requests are answered all the same.
+     *
+     * @return the number of requests cancelled
+     */
+    unsigned int cancel(const std::string& id);
+
+private:
+    struct Request {
+        std::string id;
+        std::string text;
+        /** set once the request is cancelled; shared with the handling worker. */
+        std::shared_ptr<std::atomic<bool> > cancelled;
+    };
+
+    struct Response {
+        std::string id;
+        std::string text;
+    };
+
+    /** Queues a response for the writer. */
+    void respond(const std::string& id, std::string text);
+
+    friend void publishResponse(std::ostream& out);
+
+    /** Main loop of a worker thread. */
+    void work(unsigned int worker);
+
+    /** Main loop of the writer thread. */
+    void write();
+
+    /** the function handling a single request. */
+    RequestHandler mHandler;
+    /** the stream the responses are written to. */
+    std::ostream& mOut;
+    /** number of requests submitted so far; used as default request id. */
+    unsigned long mSubmitted;
+    /** requests of no particular session; taken by any worker. */
+    std::deque<Request> mShared;
+    /** requests of named sessions, one queue per worker. */
+    std::vector<std::deque<Request> > mAssigned;
+    /** the id and flag of the request each worker is handling; without flag if none. */
+    std::vector<Request> mRunning;
+    /** completed responses waiting to be written. */
+    std::deque<Response> mResponses;
+    /** have all requests been submitted? */
+    bool mClosed;
+    /** guards the queues and the closed flag. */
+    std::mutex mMutex;
+    /** signals new requests to the workers. */
+    std::condition_variable mRequestReady;
+    /** signals new responses to the writer. */
+    std::condition_variable mResponseReady;
+    /** number of workers that have not finished yet. */
+    unsigned int mActiveWorkers;
+    std::vector<std::thread> mWorkers;
+    std::thread mWriter;
+
+    RequestPool(const RequestPool&);
+    RequestPool& operator=(const RequestPool&);
+};
+
+/**
+ * Hands the text written to the output stream of a request so far to the
+ * client as a response of its own, e.g. the first layout of a progressive
+ * request. In a worker of a pool, the text becomes a response tagged with the
+ * id of the request; otherwise, the stream is flushed.
+ */
+void publishResponse(std::ostream& out);
+
+#endif
@@ -0,0 +1,139 @@
+/**
+ * @file    RequestStats.h
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * Definition of the per-request statistics: monotonic timers for the phases
+ * of a request and counters of the graph elements and the data transferred.
+ * They are collected if a request contains the line STATS, and reported as a
+ * STATS block after the layout or appended to a side file given as
+ * STATS {path}.
+ *
+ * The phases can also be timed without reporting them, e.g. for the request
+ * recorder.
+ */
+#ifndef __REQUESTSTATS_H__INCLUDED__
+#define __REQUESTSTATS_H__INCLUDED__
+
+#include <iostream>
+#include <string>
+#include <chrono>
+
+#include "MemoryMeter.h"
+
+/** The timed phases of a request. */
+enum StatsPhase {
+    /** tokenizing and converting the lines or records. */
+    PHASE_PARSE,
+    /** creating shapes for nodes and clusters. */
+    PHASE_SHAPES,
+    /** creating pins for ports. */
+    PHASE_PINS,
+    /** creating connectors for edges. */
+    PHASE_CONNECTORS,
+    /** processTransaction(). */
+    PHASE_ROUTING,
+    /** rerouting hyperedges. */
+    PHASE_HYPEREDGES,
+    /** writing the layout. */
+    PHASE_OUTPUT,
+    PHASE_COUNT
+};
+
+typedef std::chrono::steady_clock StatsClock;
+
+struct RequestStats {
+    /** are statistics collected and reported for the request? */
+    bool enabled;
+    /** are the phases timed? set with enabled, or on its own. */
+    bool timed;
+    /** the side file the statistics are appended to; empty for the response. */
+    std::string file;
+    /** the id of the request, if given. */
+    std::string requestId;
+    /** when the statistics were enabled. */
+    StatsClock::time_point start;
+    /** the time spent in each phase. */
+    StatsClock::duration elapsed[PHASE_COUNT];
+    unsigned long shapes;
+    unsigned long pins;
+    unsigned long connectors;
+    unsigned long routePoints;
+    unsigned long bytesIn;
+    unsigned long bytesOut;
+    /** the memory meter of the request; null if it is not measured. */
+    const MemoryMeter* memory;
+
+    RequestStats() :
+        enabled(false), timed(false), shapes(0), pins(0), connectors(0), routePoints(0), bytesIn(0),
+                bytesOut(0), memory(NULL) {
+        for (int i = 0; i < PHASE_COUNT; ++i) {
+            elapsed[i] = StatsClock::duration::zero();
+        }
+    }
+
+    /** Starts collecting statistics. */
+    void enable() {
+        enabled = true;
+        startTiming();
+    }
+
+    /** Starts timing the phases without reporting them. */
+    void startTiming() {
+        if (!timed) {
+            timed = true;
+            start = StatsClock::now();
+        }
+    }
+};
+
+/**
+ * Adds the time until its destruction to a phase, if the phases are timed.
+ */
+class PhaseTimer {
+public:
+    PhaseTimer(RequestStats& stats, StatsPhase phase) :
+        mStats(stats.timed ? &stats : NULL), mPhase(phase) {
+        if (mStats != NULL) {
+            mStart = StatsClock::now();
+        }
+    }
+
+    ~PhaseTimer() {
+        if (mStats != NULL) {
+            mStats->elapsed[mPhase] += StatsClock::now() - mStart;
+        }
+    }
+
+private:
+    RequestStats* mStats;
+    StatsPhase mPhase;
+    StatsClock::time_point mStart;
+
+    PhaseTimer(const PhaseTimer&);
+    PhaseTimer& operator=(const PhaseTimer&);
+};
+
+/**
+ * Writes the statistics as STATS block, which ends with the line STATSEND.
+ */
+void writeStats(std::ostream& out, const RequestStats& stats);
+
+/**
+ * Reports the statistics of a completed request, either to the output stream
+ * or to their side file.
+ */
+void reportStats(std::ostream& out, const RequestStats& stats);
+
+#endif
@@ -0,0 +1,123 @@
+/**
+ * @file    RequestTrace.h
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * Definition of request traces, which record the requests a server has
+ * handled so that they can be replayed against another build. A trace is a
+ * gzip compressed file of records, each consisting of the line
+ *
+ *   RECORD {bytes} {hash} {parseMs} ... {outputMs} [{request id}]
+ *
+ * followed by the text of the request, {bytes} bytes including the line
+ * break of its last line. The hash identifies the routes of the response, the
+ * times are those of the phases of the STATS block. Records written by
+ * different processes must go to different files.
+ */
+#ifndef __REQUESTTRACE_H__INCLUDED__
+#define __REQUESTTRACE_H__INCLUDED__
+
+#include <string>
+#include <mutex>
+#include <stdint.h>
+#include <zlib.h>
+
+#include "RequestStats.h"
+
+struct TraceRecord {
+    /** the id of the request, if given. */
+    std::string id;
+    /** the text of the request as received. */
+    std::string request;
+    /** the hash of the response, see hashResponse(). */
+    uint64_t hash;
+    /** the time of each phase in milliseconds. */
+    double phaseMs[PHASE_COUNT];
+
+    TraceRecord() :
+        hash(0) {
+        for (int i = 0; i < PHASE_COUNT; ++i) {
+            phaseMs[i] = 0;
+        }
+    }
+};
+
+/**
+ * Appends records to a trace; may be used by concurrent requests.
+ */
+class TraceWriter {
+public:
+    TraceWriter();
+
+    ~TraceWriter();
+
+    /**
+     * Opens the trace for appending.
+     *
+     * @return false if it cannot be opened
+     */
+    bool open(const std::string& path);
+
+    /**
+     * Writes a record and flushes it, so that the trace is complete up to the
+     * last request even if the process is killed.
+     */
+    void write(const TraceRecord& record);
+
+private:
+    gzFile mFile;
+    std::mutex mMutex;
+
+    TraceWriter(const TraceWriter&);
+    TraceWriter& operator=(const TraceWriter&);
+};
+
+/**
+ * Reads the records of a trace in order.
+ */
+class TraceReader {
+public:
+    TraceReader();
+
+    ~TraceReader();
+
+    /**
+     * @return false if the trace cannot be opened
+     */
+    bool open(const std::string& path);
+
+    /**
+     * Reads the next record.
+     *
+     * @return false at the end of the trace or if it is damaged
+     */
+    bool next(TraceRecord& record);
+
+private:
+    gzFile mFile;
+
+    TraceReader(const TraceReader&);
+    TraceReader& operator=(const TraceReader&);
+};
+
+/**
+ * Hashes the layouts of a response with 64-bit FNV-1a. STATS blocks are left
+ * out, so equal routes give equal hashes.
+ */
+uint64_t hashResponse(const std::string& response);
+
+/** Copies the phase times and the id of a request to its record. */
+void recordStats(const RequestStats& stats, TraceRecord& record);
+
+#endif
@@ -0,0 +1,139 @@
+/**
+ * @file    ResultCache.h
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * Definition of the result cache. Responses are stored under a hash of the
+ * canonical form of their request, which drops comments, request ids and
+ * differences in white space. The canonical form is stored next to the
+ * response and compared on every hit, so requests whose hashes collide are
+ * not answered with each other's responses. A request that is sent again is
+ * answered from the cache without building a router.
+ *
+ * The cache keeps the least recently used responses up to a memory bound. If
+ * a directory is given, responses are also written to files there, so that
+ * they survive restarts. Requests of sessions are never cached, as their
+ * results depend on earlier requests.
+ */
+#ifndef __RESULTCACHE_H__INCLUDED__
+#define __RESULTCACHE_H__INCLUDED__
+
+#include <iostream>
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+
+/** How a request relates to the cache. */
+enum CacheUse {
+    /** the request can be answered from the cache. */
+    CACHE_USE,
+    /** the request has to be routed every time. */
+    CACHE_BYPASS,
+    /** the request asks for the cache statistics. */
+    CACHE_STATS
+};
+
+class ResultCache {
+public:
+    /**
+     * Constructs an empty cache.
+     *
+     * @param maxBytes
+     *            the maximum size of the requests and responses kept in memory
+     * @param directory
+     *            the directory responses are spilled to; empty for none
+     */
+    ResultCache(size_t maxBytes, const std::string& directory);
+
+    /**
+     * Computes the cache key of a request.
+     *
+     * @param request
+     *            the complete text of the request
+     * @param key
+     *            set to the key if the request can be cached
+     * @param canonical
+     *            set to the canonical form of the request if it can be cached
+     * @return how the request relates to the cache
+     */
+    static CacheUse canonicalKey(const std::string& request, std::string& key,
+            std::string& canonical);
+
+    /**
+     * Looks up the response for a key, in memory first and on disk second.
+     *
+     * @param canonical
+     *            the canonical form of the request, which must equal the
+     *            stored one
+     * @return true on a hit
+     */
+    bool lookup(const std::string& key, const std::string& canonical, std::string& response);
+
+    /**
+     * Stores the response for a key, evicting the least recently used
+     * responses as necessary.
+     */
+    void store(const std::string& key, const std::string& canonical,
+            const std::string& response);
+
+    /**
+     * Writes the hit and miss counters as CACHESTATS response.
+     */
+    void writeStats(std::ostream& out);
+
+private:
+    struct Entry {
+        std::string key;
+        std::string canonical;
+        std::string response;
+    };
+
+    typedef std::list<Entry> EntryList;
+
+    /** Inserts an entry into memory; the mutex must be held. */
+    void insert(const std::string& key, const std::string& canonical,
+            const std::string& response);
+
+    /**
+     * Reads the file of a key.
+     *
+     * @return false if there is none or it belongs to another request
+     */
+    bool readFile(const std::string& key, const std::string& canonical,
+            std::string& response) const;
+
+    /** @return the path of the file of a key */
+    std::string path(const std::string& key) const;
+
+    /** the maximum size of the requests and responses kept in memory. */
+    size_t mMaxBytes;
+    /** the size of the requests and responses kept in memory. */
+    size_t mBytes;
+    /** the spill directory, empty for none. */
+    std::string mDirectory;
+    /** the entries, most recently used first. */
+    EntryList mEntries;
+    /** the entries by key. */
+    std::unordered_map<std::string, EntryList::iterator> mIndex;
+    unsigned long mHits;
+    unsigned long mMisses;
+    /** guards the entries and counters; the cache is shared by all workers. */
+    std::mutex mMutex;
+
+    ResultCache(const ResultCache&);
+    ResultCache& operator=(const ResultCache&);
+};
+
+#endif
@@ -0,0 +1,91 @@
+/**
+ * @file    RouterConfig.h
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * Definition of router configurations and named profiles. A configuration
+ * holds the edge routing, penalties and routing options of a request in the
+ * form of libavoid's enums, so that it can be applied to any number of routers
+ * without looking at the option ids again. Profiles are configurations stored
+ * under a name with PROFILE define and applied by later requests with
+ * PROFILE use; they live as long as the process.
+ */
+#ifndef __ROUTERCONFIG_H__INCLUDED__
+#define __ROUTERCONFIG_H__INCLUDED__
+
+#include <string>
+
+#include "libavoid/libavoid.h"
+
+/**
+ * The edge routing, penalties and routing options of a router.
+ */
+struct RouterConfig {
+    /** connector type of all edges. */
+    Avoid::ConnType connectorType;
+    /** has a penalty been given? */
+    bool penaltySet[Avoid::lastRoutingParameterMarker];
+    double penalties[Avoid::lastRoutingParameterMarker];
+    /** has a routing option been given? */
+    bool optionSet[Avoid::lastRoutingOptionMarker];
+    bool options[Avoid::lastRoutingOptionMarker];
+
+    /** Creates an orthogonal configuration with libavoid's defaults. */
+    RouterConfig();
+
+    /** Forgets all penalties and routing options. */
+    void clear();
+
+    /**
+     * Records a penalty, after reporting an error if the id is unknown.
+     *
+     * @param router
+     *            the router the penalty is also applied to; null for none
+     * @return false if the id is unknown
+     */
+    bool setPenalty(const char* optionId, const char* token, Avoid::Router* router = NULL);
+
+    /**
+     * Records a routing option, after reporting an error if the id is unknown.
+     *
+     * @param router
+     *            the router the option is also applied to; null for none
+     * @return false if the id is unknown
+     */
+    bool setOption(const char* optionId, const char* token, Avoid::Router* router = NULL);
+
+    /** Records the penalties and routing options that are set in the other configuration. */
+    void merge(const RouterConfig& other);
+
+    /** Applies the recorded penalties to the router. */
+    void applyPenalties(Avoid::Router* router) const;
+
+    /** Applies the recorded routing options to the router. */
+    void applyOptions(Avoid::Router* router) const;
+};
+
+/**
+ * Stores a profile, replacing the one with the same name. May be called from
+ * any thread.
+ */
+void defineProfile(const std::string& name, const RouterConfig& config);
+
+/**
+ * Looks up a profile. May be called from any thread.
+ *
+ * @return false if there is no profile of that name
+ */
+bool findProfile(const std::string& name, RouterConfig& config);
+
+#endif
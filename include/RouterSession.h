@@ -0,0 +1,115 @@
+/**
+ * @file    RouterSession.h
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * Definition of router sessions. A session holds the router and the graph
+ * elements of a request. Named sessions survive the end of a request, so that
+ * later requests can send incremental changes (moved, resized, added or removed
+ * elements) which are passed to libavoid's own transaction mechanism. Only the
+ * connectors whose routes changed are written back in that case.
+ */
+#ifndef __ROUTERSESSION_H__INCLUDED__
+#define __ROUTERSESSION_H__INCLUDED__
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+
+#include "libavoid/libavoid.h"
+#include "LibavoidRouting.h"
+#include "RoutingControl.h"
+
+/**
+ * A connector of a session together with the information needed to update it.
+ */
+struct SessionEdge {
+    /** the libavoid connector. */
+    Avoid::ConnRef* conn;
+    /** id of the source node. */
+    ElementId srcNode;
+    /** id of the target node. */
+    ElementId tgtNode;
+    /** the route that has been written most recently. */
+    Avoid::PolyLine route;
+};
+
+/**
+ * The router and graph elements of a request.
+ */
+struct RouterSession {
+    /** the router; initialized upon receiption of the first option or element. */
+    ControlledRouter* router;
+    /** connector type of all edges. */
+    Avoid::ConnType connectorType;
+    /** layout direction used for port-less edges. */
+    std::string direction;
+    /** how pins of port-less edges are created. */
+    PinOptions pins;
+    /** the nodes, clusters and ports by their ids. */
+    GraphIndex index;
+    /** the connectors in order of creation. */
+    std::vector<Avoid::ConnRef*> cons;
+    /** the connectors indexed by edge id; only maintained for named sessions. */
+    std::unordered_map<unsigned int, SessionEdge> edges;
+
+    /**
+     * @param arena
+     *            the arena for the index; null for sessions that outlive the
+     *            request
+     */
+    explicit RouterSession(Arena* arena = NULL) :
+        router(NULL), connectorType(Avoid::ConnType_Orthogonal), direction(DIRECTION_UNDEFINED),
+        index(arena) {
+    }
+
+    ~RouterSession() {
+        // the router takes care of all shapes, pins and connectors
+        delete router;
+    }
+
+private:
+    RouterSession(const RouterSession&);
+    RouterSession& operator=(const RouterSession&);
+};
+
+/** Named sessions that are kept alive between requests. */
+typedef std::map<std::string, RouterSession*> SessionMap;
+
+/**
+ * Updating a session
+ */
+void addSessionNode(const NodeRecord& node, RouterSession& session);
+
+/** @return the connector of the edge, or null if it cannot be added */
+Avoid::ConnRef* addSessionEdge(const EdgeRecord& edge, RouterSession& session);
+
+void moveNode(ElementId nodeId, double dx, double dy, RouterSession& session);
+
+void resizeNode(ElementId nodeId, double x1, double y1, double x2, double y2,
+        RouterSession& session);
+
+void removeNode(ElementId nodeId, RouterSession& session);
+
+void removeEdge(unsigned int edgeId, RouterSession& session);
+
+/**
+ * Collecting the connectors of the session whose routes changed since the
+ * last call
+ */
+void collectChangedConnectors(RouterSession& session, std::vector<Avoid::ConnRef*>& changed);
+
+#endif
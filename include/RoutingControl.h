@@ -0,0 +1,226 @@
+/**
+ * @file    RoutingControl.h
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * Definition of the control of running requests: a time and a memory limit per
+ * request and the cancellation of requests by their id. All are checked by
+ * libavoid between the steps of a transaction, which is then aborted. The routes found
+ * so far are kept; connectors without a route get a simple fallback route, and
+ * the response marks each edge with the state of its route.
+ */
+#ifndef __ROUTINGCONTROL_H__INCLUDED__
+#define __ROUTINGCONTROL_H__INCLUDED__
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "libavoid/libavoid.h"
+#include "MemoryMeter.h"
+
+/**
+ * The time limit and cancellation state of a request.
+ */
+class RoutingControl {
+public:
+    /** Starts the clock of the time limit. */
+    RoutingControl();
+
+    /**
+     * @param milliseconds
+     *            the time the request may take, counted from its start; 0 for
+     *            no limit
+     */
+    void setTimeLimit(unsigned int milliseconds);
+
+    /**
+     * @param bytes
+     *            the memory the request may allocate, measured by the meter
+     *            given to measure(); 0 for no limit
+     */
+    void setMemoryLimit(size_t bytes) {
+        mMemoryLimit = bytes;
+    }
+
+    /**
+     * @param meter
+     *            the meter of the request, which outlives the control
+     */
+    void measure(const MemoryMeter* meter) {
+        mMeter = meter;
+    }
+
+    /** @return true if the request has a time or memory limit */
+    bool limited() const {
+        return mLimited || mMemoryLimit > 0;
+    }
+
+    /** @return true if the request has allocated more than its memory limit */
+    bool overMemoryLimit() const {
+        return mMemoryLimit > 0 && mMeter != NULL && mMeter->current() > (int64_t) mMemoryLimit;
+    }
+
+    /** May be called from any thread. */
+    void cancel() {
+        mCancelled = true;
+    }
+
+    bool cancelled() const {
+        return mCancelled || (mCancelFlag != NULL && *mCancelFlag);
+    }
+
+    /**
+     * Makes the request also count as cancelled once the given flag is set.
+     *
+     * @param flag
+     *            a flag that outlives the request; null for none
+     */
+    void watch(const std::atomic<bool>* flag) {
+        mCancelFlag = flag;
+    }
+
+    /**
+     * @return true if the request has been cancelled, its time is up or it
+     *         exceeds its memory limit
+     */
+    bool expired() const;
+
+private:
+    std::chrono::steady_clock::time_point mStart;
+    std::chrono::steady_clock::time_point mDeadline;
+    bool mLimited;
+    std::atomic<bool> mCancelled;
+    const std::atomic<bool>* mCancelFlag;
+    size_t mMemoryLimit;
+    const MemoryMeter* mMeter;
+
+    RoutingControl(const RoutingControl&);
+    RoutingControl& operator=(const RoutingControl&);
+};
+
+/**
+ * A router whose transactions are aborted once the request that runs them has
+ * expired.
+ */
+class ControlledRouter: public Avoid::Router {
+public:
+    explicit ControlledRouter(unsigned int flags);
+
+    /**
+     * Ends each transaction after the given phase, e.g. to skip the crossing
+     * detection and nudging that follow the route search. This does not count
+     * as abort.
+     *
+     * @param phase
+     *            the last phase to run, one of Avoid::TransactionPhases; 0 for
+     *            all
+     */
+    void setLastPhase(unsigned int phase) {
+        mLastPhase = phase;
+    }
+
+    /**
+     * Processes the pending transaction under the given control.
+     *
+     * @param control
+     *            the control of the request; null for none
+     * @return false if the transaction was aborted
+     */
+    bool route(const RoutingControl* control);
+
+    /** @return true if the most recent transaction was aborted */
+    bool aborted() const {
+        return mAborted;
+    }
+
+    virtual bool shouldContinueTransactionWithProgress(unsigned int elapsedTime,
+            unsigned int phaseNumber, unsigned int totalPhases, double proportion);
+
+private:
+    const RoutingControl* mControl;
+    bool mAborted;
+    unsigned int mLastPhase;
+};
+
+/** State of the route of a connector in a response. */
+enum RouteStatus {
+    /** the transaction was completed. */
+    ROUTE_COMPLETE,
+    /** the route was found, but the transaction was aborted before it was finished. */
+    ROUTE_PARTIAL,
+    /** no route was found in time; a straight or orthogonal fallback is used. */
+    ROUTE_FALLBACK
+};
+
+/** The keywords of the route states, indexed by RouteStatus. */
+extern const char* const ROUTE_STATUS_NAMES[];
+
+/**
+ * The states of the routes of a response, in the order of its connectors.
+ */
+struct RouteReport {
+    std::vector<RouteStatus> status;
+    /** the fallback routes; empty for connectors that have a route. */
+    std::vector<Avoid::PolyLine> fallbacks;
+
+    /** @return the route to write for the i-th connector */
+    const Avoid::PolyLine& route(size_t i, Avoid::ConnRef* con) const {
+        return status[i] == ROUTE_FALLBACK ? fallbacks[i] : con->displayRoute();
+    }
+
+    /** @return true if all transactions were completed */
+    bool complete() const;
+};
+
+/**
+ * Determines the states of the routes of the given connectors and computes
+ * fallback routes where needed. All routers must be ControlledRouters.
+ */
+void reportRoutes(const std::vector<Avoid::ConnRef*>& cons, RouteReport& report);
+
+/**
+ * Makes a request cancellable by its id until it is unregistered.
+ */
+void registerRequest(const std::string& id, RoutingControl* control);
+
+void unregisterRequest(RoutingControl* control);
+
+/**
+ * Cancels the running requests with the given id, or all running requests if
+ * the id is empty.
+ *
+ * @return the number of requests cancelled
+ */
+unsigned int cancelRequests(const std::string& id);
+
+/**
+ * Sets the flag that cancels the requests of the calling thread; used by
+ * workers that know the requests before they are parsed.
+ */
+void setThreadCancelFlag(const std::atomic<bool>* flag);
+
+/** @return the flag that cancels the requests of the calling thread, or null */
+const std::atomic<bool>* threadCancelFlag();
+
+/**
+ * Reads CANCEL [request id] lines from the given file in a background thread
+ * and passes the ids to the given function. A named pipe is opened again
+ * whenever its writer closes it.
+ */
+void startControlChannel(const std::string& path, unsigned int (*cancel)(const std::string&));
+
+#endif
@@ -0,0 +1,207 @@
+/**
+ * @file    RoutingRequest.h
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * Definition of a routing request. The request receives the commands and graph
+ * elements in the order in which they are read, independently of the protocol
+ * they were encoded with, sets up the router and performs the routing.
+ */
+#ifndef __ROUTINGREQUEST_H__INCLUDED__
+#define __ROUTINGREQUEST_H__INCLUDED__
+
+#include <vector>
+
+#include "libavoid/libavoid.h"
+#include "GraphRecords.h"
+#include "LineParser.h"
+#include "RouterSession.h"
+#include "RequestStats.h"
+#include "ComponentRouting.h"
+#include "Arena.h"
+#include "RoutingControl.h"
+#include "RouterConfig.h"
+#include "MemoryMeter.h"
+
+class RoutingRequest {
+public:
+    /**
+     * Constructs an empty request.
+     *
+     * @param sessions
+     *            the named sessions kept alive between requests
+     */
+    explicit RoutingRequest(SessionMap& sessions);
+
+    /** Ends the cancellability of the request. */
+    ~RoutingRequest();
+
+    /**
+     * Handles a line of the text protocol.
+     *
+     * @param tokens
+     *            the parsed line
+     * @return false if the request is complete
+     */
+    bool handleLine(LineParser& tokens);
+
+    /*
+     * Handling graph elements that have already been decoded
+     */
+    void handleNode(const NodeRecord& node);
+
+    void handleCluster(const ClusterRecord& cluster);
+
+    void handlePort(const PortRecord& port);
+
+    /**
+     * @param fixedRoute
+     *            the route of a FIXED edge, which is kept as it is and is not
+     *            part of the response; null for an edge to be routed
+     */
+    void handleEdge(const EdgeRecord& edge, const Avoid::PolyLine* fixedRoute = NULL);
+
+    /**
+     * Performs the quick first pass of a progressive request, whose routes are
+     * replaced by those of route().
+     *
+     * @return false if the request is not progressive or contains nothing to
+     *         route
+     */
+    bool routeCoarse();
+
+    /**
+     * Performs the connector routing.
+     *
+     * @return false if the request contains nothing to route
+     */
+    bool route();
+
+    /**
+     * Collects the connectors whose routes are part of the response: all
+     * connectors, or for named sessions only those whose routes changed;
+     * connectors with fixed routes are left out.
+     *
+     * @param cons
+     *            the vector the connectors are added to
+     */
+    void result(std::vector<Avoid::ConnRef*>& cons);
+
+    /**
+     * Collects the routes of the hyperedges, whose edges are not part of the
+     * connectors of result().
+     */
+    void hyperedges(std::vector<Hyperedge>& hyperedges) const;
+
+    /**
+     * Determines the states of the routes of the given result, which are part
+     * of the response if the request has a time limit or has been cancelled.
+     *
+     * @param cons
+     *            the connectors of the result
+     * @param report
+     *            receives the states and fallback routes
+     * @return false if the response does not include the states
+     */
+    bool report(const std::vector<Avoid::ConnRef*>& cons, RouteReport& report);
+
+    /**
+     * @return the statistics of the request, which are collected if the
+     *         request contains STATS
+     */
+    RequestStats& stats() {
+        return mStats;
+    }
+
+    /**
+     * @return the number of decimals of the coordinates of the response, or
+     *         EXACT_PRECISION
+     */
+    int precision() const {
+        return mPrecision;
+    }
+
+private:
+    /** Creates the default router if necessary and checks the graph declaration. */
+    void beginElement();
+
+    /** Creates the default router if necessary. */
+    void ensureRouter();
+
+    /** Replaces the router by a new one, which discards the penalties and routing options. */
+    void createRouter(Avoid::ConnType connectorType);
+
+    /** Applies the edge routing, penalties and routing options of a profile. */
+    void useProfile(const char* name);
+
+    /** Are the elements collected for the component router? */
+    bool collected() const {
+        return mSplit || mProgressive || mClipped;
+    }
+
+    /** Prepares the graph for the given number of elements. */
+    void reserve(size_t nodes, size_t edges, size_t ports);
+
+    /** the memory allocated by the request. */
+    MemoryMeter mMemory;
+    /** counts the allocations of the thread until all other members are gone. */
+    MemoryScope mMemoryScope;
+    /** resets the arena of the thread once all other members are gone. */
+    ArenaScope mArenaScope;
+    /** the named sessions. */
+    SessionMap& mSessions;
+    /** the graph of a request without SESSION declaration only lives for this request. */
+    RouterSession mRequestSession;
+    /** the session the graph is added to. */
+    RouterSession* mSession;
+    /** is the graph kept alive for later requests? */
+    bool mNamed;
+    /** does the request update the graph of an existing session? */
+    bool mUpdate;
+    /** has the request been ended by closing a session? */
+    bool mClosed;
+    /** should we print debug information? */
+    bool mDebug;
+    /** has the graph declaration started? */
+    bool mGraphDecl;
+    /** have hyperedges been enabled? will result in decreased performance */
+    bool mHyperedges;
+    /** the edges that leave the same port, if hyperedges are enabled. */
+    HyperedgeCollector mNets;
+    /** the routes of the hyperedges. */
+    std::vector<Hyperedge> mHyperedgeRoutes;
+    /** the statistics of the request. */
+    RequestStats mStats;
+    /** the time limit and cancellation of the request. */
+    RoutingControl mControl;
+    /** should independent groups be routed separately? */
+    bool mSplit;
+    /** should a coarse layout be written before the final one? */
+    bool mProgressive;
+    /** is the routing restricted to a viewport? */
+    bool mClipped;
+    /** the spacing by which the bounding boxes of groups are enlarged. */
+    double mComponentSpacing;
+    /** the number of decimals of the coordinates of the response. */
+    int mPrecision;
+    /** the penalties and routing options, replayed for the router of each group. */
+    RouterSetup mSetup;
+    /** the graph if it is routed in groups or progressively. */
+    ComponentRouter mComponents;
+
+    RoutingRequest(const RoutingRequest&);
+    RoutingRequest& operator=(const RoutingRequest&);
+};
+
+#endif
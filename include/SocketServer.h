@@ -0,0 +1,135 @@
+/**
+ * @file    SocketServer.h
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * Definition of the socket mode, in which a single process listens on a Unix
+ * domain socket and serves each connection in a thread of its own, so that any
+ * number of clients can use the same process at the same time. A connection is
+ * served like the standard input of a server process. Also defines a shared
+ * memory region that a client maps together with the server, so that requests
+ * and routes do not have to be copied through the socket. Not available on
+ * Windows.
+ *
+ * The shared memory protocol is selected by the line PROTOCOL SHARED {path}
+ * instead of a request; the server maps the file, which the client has
+ * created, and answers with the same line, or PROTOCOL TEXT if it cannot. From
+ * then on, the client sends one line per request:
+ *
+ *   SHARED {offset} {length} {result offset} {result capacity}
+ *
+ * where the text of the request, ending with a line break, is found at the
+ * offset in the file. The server parses it in place, which modifies it, and
+ * encodes the routes like the payload of a binary LAYOUT frame at the result
+ * offset. It answers with LAYOUT {result offset} {size}, or OVERFLOW {size}
+ * if the result does not fit, followed by the text lines the binary protocol
+ * sends as TEXT frames and a line DONE.
+ */
+#ifndef __SOCKETSERVER_H__INCLUDED__
+#define __SOCKETSERVER_H__INCLUDED__
+
+#include <streambuf>
+#include <string>
+#include <vector>
+
+/** The handshake answer if the shared memory protocol is used. */
+#define PROTOCOL_SHARED "PROTOCOL SHARED"
+
+/**
+ * Serves a connection, which is both read and written through the given file
+ * descriptor. The caller closes it afterwards.
+ *
+ * @return the exit code of a single server process
+ */
+typedef int (*ConnectionHandler)(int fd);
+
+/**
+ * Creates a socket that listens on the given path, which is replaced if it
+ * exists.
+ *
+ * @return the file descriptor of the socket, or -1 after reporting an error
+ */
+int listenOnSocket(const std::string& path);
+
+/**
+ * Serves connections until SIGINT or SIGTERM is received, each in a thread of
+ * its own.
+ *
+ * @return the exit code of the server
+ */
+int runSocketServer(const std::string& path, ConnectionHandler serve);
+
+/**
+ * An output buffer that writes to a file descriptor, e.g. a connection.
+ */
+class FdOutputBuffer: public std::streambuf {
+public:
+    explicit FdOutputBuffer(int fd);
+
+    virtual ~FdOutputBuffer();
+
+protected:
+    virtual int_type overflow(int_type c);
+
+    virtual int sync();
+
+    virtual std::streamsize xsputn(const char* data, std::streamsize count);
+
+private:
+    /** @return false if the buffered bytes cannot be written */
+    bool drain();
+
+    int mFd;
+    std::vector<char> mBuffer;
+};
+
+/**
+ * A file that is mapped into the memory of both the server and a client.
+ */
+class SharedRegion {
+public:
+    SharedRegion();
+
+    /** Unmaps the file. */
+    ~SharedRegion();
+
+    /**
+     * Maps the whole file, which the client has created, e.g. in /dev/shm.
+     *
+     * @return false after reporting an error if it cannot be mapped
+     */
+    bool map(const std::string& path);
+
+    char* data() const {
+        return mData;
+    }
+
+    size_t size() const {
+        return mSize;
+    }
+
+    /** @return true if the given range lies within the region */
+    bool contains(size_t offset, size_t length) const {
+        return offset <= mSize && length <= mSize - offset;
+    }
+
+private:
+    char* mData;
+    size_t mSize;
+
+    SharedRegion(const SharedRegion&);
+    SharedRegion& operator=(const SharedRegion&);
+};
+
+#endif
@@ -0,0 +1,82 @@
+/**
+ * @file    SpatialGrid.h
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * Definition of a uniform grid over axis-parallel boxes, which finds the boxes
+ * that intersect an area without looking at all of them. The cell size is
+ * derived from the average size of the boxes, so that a box covers few cells
+ * and a cell holds few boxes, and the number of cells is limited by the number
+ * of boxes. The cells are stored as one array of box indices with an offset
+ * per cell.
+ */
+#ifndef __SPATIALGRID_H__INCLUDED__
+#define __SPATIALGRID_H__INCLUDED__
+
+#include <cstddef>
+#include <vector>
+
+/** An axis-parallel box. */
+struct Box {
+    double x1;
+    double y1;
+    double x2;
+    double y2;
+
+    void include(const Box& other);
+
+    bool overlaps(const Box& other) const {
+        return x1 <= other.x2 && other.x1 <= x2 && y1 <= other.y2 && other.y1 <= y2;
+    }
+
+    /** @return the box enlarged by the given margin on each side */
+    Box enlarged(double margin) const {
+        Box box = { x1 - margin, y1 - margin, x2 + margin, y2 + margin };
+        return box;
+    }
+};
+
+class SpatialGrid {
+public:
+    SpatialGrid();
+
+    /**
+     * Builds the grid; the boxes are referred to by their indices.
+     */
+    void build(const std::vector<Box>& boxes);
+
+    /**
+     * Adds the indices of all boxes that intersect the area to the result,
+     * each once and in ascending order.
+     */
+    void query(const Box& area, std::vector<size_t>& result) const;
+
+private:
+    /** @return the range of cells covered by the box, clamped to the grid */
+    void cellRange(const Box& box, size_t& col1, size_t& row1, size_t& col2, size_t& row2) const;
+
+    std::vector<Box> mBoxes;
+    /** the origin of the grid. */
+    double mX;
+    double mY;
+    double mCellSize;
+    size_t mCols;
+    size_t mRows;
+    /** the start of each cell in mEntries, and the end of the last one. */
+    std::vector<size_t> mOffsets;
+    /** the box indices of all cells. */
+    std::vector<size_t> mEntries;
+};
+
+#endif
@@ -0,0 +1,78 @@
+/**
+ * @file    Arena.cpp
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * The implementation of the arena defined in Arena.h.
+ */
+#include "Arena.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+using namespace std;
+
+const size_t Arena::DEFAULT_BLOCK_SIZE;
+const size_t Arena::MAX_RETAINED;
+
+Arena::Arena() :
+        mBlock(NULL), mUsed(0), mCapacity(0), mReserved(0) {
+}
+
+Arena::~Arena() {
+    for (size_t i = 0; i < mBlocks.size(); ++i) {
+        free(mBlocks[i]);
+    }
+}
+
+void Arena::addBlock(size_t capacity) {
+    char* block = static_cast<char*>(malloc(capacity));
+    if (block == NULL) {
+        throw bad_alloc();
+    }
+    mBlocks.push_back(block);
+    mBlock = block;
+    mUsed = 0;
+    mCapacity = capacity;
+    mReserved += capacity;
+}
+
+void* Arena::allocateBlock(size_t size, size_t alignment) {
+    // blocks grow geometrically, so that a large request needs few of them
+    addBlock(max(max(DEFAULT_BLOCK_SIZE, mReserved), size + alignment));
+    return allocate(size, alignment);
+}
+
+void Arena::reset() {
+    if (mBlocks.size() > 1 || mReserved > MAX_RETAINED) {
+        size_t total = min(mReserved, MAX_RETAINED);
+        for (size_t i = 0; i < mBlocks.size(); ++i) {
+            free(mBlocks[i]);
+        }
+        mBlocks.clear();
+        mBlock = NULL;
+        mCapacity = 0;
+        mReserved = 0;
+        if (total > DEFAULT_BLOCK_SIZE) {
+            addBlock(total);
+        }
+    }
+    mUsed = 0;
+}
+
+Arena& threadArena() {
+    // each thread handles one request at a time
+    static thread_local Arena arena;
+    return arena;
+}
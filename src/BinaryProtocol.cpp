@@ -0,0 +1,219 @@
+/**
+ * @file    BinaryProtocol.cpp
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * The implementation of the binary protocol defined in BinaryProtocol.h. The
+ * byte order is handled with shifts, so the encoding does not depend on the
+ * byte order of the host.
+ */
+#include "BinaryProtocol.h"
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <stdint.h>
+
+#include "libavoid/libavoid.h"
+
+using namespace std;
+
+/** Upper bound of the payload size, protecting against corrupt length prefixes. */
+const uint32_t MAX_PAYLOAD = 1u << 30;
+
+static uint32_t getU32(const char*& data) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+    data += 4;
+    return (uint32_t) bytes[0] | ((uint32_t) bytes[1] << 8) | ((uint32_t) bytes[2] << 16)
+            | ((uint32_t) bytes[3] << 24);
+}
+
+static uint64_t getU64(const char*& data) {
+    uint64_t low = getU32(data);
+    return low | ((uint64_t) getU32(data) << 32);
+}
+
+static double getF64(const char*& data) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+    data += 8;
+    uint64_t bits = 0;
+    for (int i = 7; i >= 0; --i) {
+        bits = (bits << 8) | bytes[i];
+    }
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static void putU32(string& buffer, uint32_t value) {
+    char bytes[4];
+    for (int i = 0; i < 4; ++i) {
+        bytes[i] = (char) ((value >> (8 * i)) & 0xff);
+    }
+    buffer.append(bytes, 4);
+}
+
+static void storeU32(char*& data, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        *data++ = (char) ((value >> (8 * i)) & 0xff);
+    }
+}
+
+static void storeF64(char*& data, double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    for (int i = 0; i < 8; ++i) {
+        *data++ = (char) ((bits >> (8 * i)) & 0xff);
+    }
+}
+
+bool readFrame(ByteSource& in, unsigned char& type, vector<char>& payload) {
+    char header[5];
+    if (!in.read(header, sizeof(header))) {
+        return false;
+    }
+    const char* data = header;
+    uint32_t length = getU32(data);
+    type = (unsigned char) header[4];
+    if (length > MAX_PAYLOAD) {
+        cerr << "ERROR: invalid frame length " << length << "." << endl;
+        return false;
+    }
+    payload.resize(length);
+    return length == 0 || in.read(&payload[0], length);
+}
+
+void decodeNode(const char*& data, NodeRecord& node) {
+    node.id = getU64(data);
+    node.x1 = getF64(data);
+    node.y1 = getF64(data);
+    node.x2 = getF64(data);
+    node.y2 = getF64(data);
+    node.incoming = (int32_t) getU32(data);
+    node.outgoing = (int32_t) getU32(data);
+}
+
+void decodeCluster(const char*& data, ClusterRecord& cluster) {
+    cluster.id = getU64(data);
+    cluster.x1 = getF64(data);
+    cluster.y1 = getF64(data);
+    cluster.x2 = getF64(data);
+    cluster.y2 = getF64(data);
+}
+
+bool decodePort(const char*& data, PortRecord& port) {
+    port.id = getU64(data);
+    port.node = getU64(data);
+    unsigned char side = (unsigned char) *data++;
+    port.x = getF64(data);
+    port.y = getF64(data);
+    if (side > SIDE_WEST) {
+        return false;
+    }
+    port.side = (PortSide) side;
+    return true;
+}
+
+void decodeEdge(const char*& data, EdgeRecord& edge) {
+    unsigned char flags = (unsigned char) *data++;
+    edge.hasSourcePort = (flags & 1) != 0;
+    edge.hasTargetPort = (flags & 2) != 0;
+    edge.id = getU32(data);
+    edge.source = getU64(data);
+    edge.target = getU64(data);
+    edge.sourcePort = getU64(data);
+    edge.targetPort = getU64(data);
+}
+
+/**
+ * Writes a frame to the output stream and flushes it.
+ *
+ * @return the number of bytes written
+ */
+static size_t writeFrame(ostream& out, unsigned char type, const string& payload) {
+    string header;
+    putU32(header, (uint32_t) payload.size());
+    header += (char) type;
+    out.write(header.data(), header.size());
+    out.write(payload.data(), payload.size());
+    out.flush();
+    return header.size() + payload.size();
+}
+
+/**
+ * @return the route of the i-th connector; the display route contains the
+ *         nudging, see writeLayout
+ */
+static const Avoid::PolyLine& layoutRoute(const vector<Avoid::ConnRef*>& cons, size_t i,
+        const RouteReport* report) {
+    return report != NULL ? report->route(i, cons[i]) : cons[i]->displayRoute();
+}
+
+size_t layoutSize(const vector<Avoid::ConnRef*>& cons, const RouteReport* report) {
+    size_t size = 4;
+    for (size_t i = 0; i < cons.size(); ++i) {
+        size += 8 + 16 * layoutRoute(cons, i, report).ps.size();
+    }
+    return size;
+}
+
+void encodeLayout(char* data, const vector<Avoid::ConnRef*>& cons, const RouteReport* report) {
+    storeU32(data, (uint32_t) cons.size());
+    for (size_t i = 0; i < cons.size(); ++i) {
+        const Avoid::PolyLine& route = layoutRoute(cons, i, report);
+        storeU32(data, cons[i]->id());
+        storeU32(data, (uint32_t) route.ps.size());
+        for (size_t j = 0; j < route.ps.size(); ++j) {
+            storeF64(data, route.ps[j].x);
+            storeF64(data, route.ps[j].y);
+        }
+    }
+}
+
+size_t writeLayoutFrame(ostream& out, const vector<Avoid::ConnRef*>& cons,
+        const RouteReport* report, const vector<Hyperedge>* hyperedges) {
+    string payload(layoutSize(cons, report), '\0');
+    encodeLayout(&payload[0], cons, report);
+    size_t written = writeFrame(out, FRAME_LAYOUT, payload);
+    if (report != NULL) {
+        written += writeFrame(out, FRAME_TEXT, routeStates(cons, *report));
+    }
+    if (hyperedges != NULL && !hyperedges->empty()) {
+        written += writeFrame(out, FRAME_TEXT, hyperedgeLines(*hyperedges));
+    }
+    return written;
+}
+
+string routeStates(const vector<Avoid::ConnRef*>& cons, const RouteReport& report) {
+    ostringstream states;
+    for (size_t i = 0; i < cons.size(); ++i) {
+        states << "ROUTE " << cons[i]->id() << " " << ROUTE_STATUS_NAMES[report.status[i]] << "\n";
+    }
+    return states.str();
+}
+
+string hyperedgeLines(const vector<Hyperedge>& hyperedges) {
+    // the same format as in the text protocol
+    LayoutWriter lines(0);
+    for (size_t i = 0; i < hyperedges.size(); ++i) {
+        lines.appendHyperedge(hyperedges[i]);
+    }
+    return lines.text();
+}
+
+void writeTextFrame(ostream& out, const string& text) {
+    writeFrame(out, FRAME_TEXT, text);
+}
@@ -0,0 +1,467 @@
+/**
+ * @file    ComponentRouting.cpp
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * The implementation of the component router defined in ComponentRouting.h.
+ */
+#include "ComponentRouting.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+#include "libavoid/libavoid.h"
+#include "LibavoidRouting.h"
+#include "SpatialGrid.h"
+#include "MemoryMeter.h"
+
+using namespace std;
+
+namespace {
+
+/** Union-find with path halving. */
+class DisjointSets {
+public:
+    explicit DisjointSets(size_t size) :
+        mParent(size) {
+        for (size_t i = 0; i < size; ++i) {
+            mParent[i] = i;
+        }
+    }
+
+    size_t find(size_t i) {
+        while (mParent[i] != i) {
+            mParent[i] = mParent[mParent[i]];
+            i = mParent[i];
+        }
+        return i;
+    }
+
+    /** @return false if both were in the same set already */
+    bool unite(size_t a, size_t b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) {
+            return false;
+        }
+        mParent[max(a, b)] = min(a, b);
+        return true;
+    }
+
+private:
+    vector<size_t> mParent;
+};
+
+bool compareX1(const pair<Box, size_t>& a, const pair<Box, size_t>& b) {
+    return a.first.x1 < b.first.x1;
+}
+
+}
+
+ComponentRouter::ComponentRouter(Arena* arena) :
+        mShapeIds(arena), mClipped(false), mViewportMargin(0), mGrouped(false) {
+}
+
+void ComponentRouter::setViewport(const Box& viewport, double margin) {
+    mClipped = true;
+    mViewport = viewport;
+    mViewportMargin = margin;
+}
+
+ComponentRouter::~ComponentRouter() {
+    // the routers take care of all shapes, pins and connectors
+    for (size_t i = 0; i < mRouters.size(); ++i) {
+        delete mRouters[i];
+    }
+}
+
+void ComponentRouter::reserve(size_t nodes, size_t edges, size_t ports) {
+    mNodes.reserve(nodes);
+    mShapes.reserve(nodes);
+    mShapeIds.reserve(nodes);
+    mEdges.reserve(edges);
+    mPorts.reserve(ports);
+}
+
+void ComponentRouter::addNode(const NodeRecord& node) {
+    if (!mShapeIds.insert(node.id, mShapes.size())) {
+        cerr << "ERROR: duplicate node " << node.id << "." << endl;
+        return;
+    }
+    Shape shape = { false, mNodes.size() };
+    mShapes.push_back(shape);
+    mNodes.push_back(node);
+}
+
+void ComponentRouter::addCluster(const ClusterRecord& cluster) {
+    if (!mShapeIds.insert(cluster.id, mShapes.size())) {
+        cerr << "ERROR: duplicate node " << cluster.id << "." << endl;
+        return;
+    }
+    Shape shape = { true, mClusters.size() };
+    mShapes.push_back(shape);
+    mClusters.push_back(cluster);
+}
+
+void ComponentRouter::addPort(const PortRecord& port) {
+    mPorts.push_back(port);
+}
+
+void ComponentRouter::addEdge(const EdgeRecord& edge, const Avoid::PolyLine* fixedRoute) {
+    if (fixedRoute != NULL) {
+        mFixedRoutes[mEdges.size()] = *fixedRoute;
+    }
+    mEdges.push_back(edge);
+}
+
+size_t ComponentRouter::findNode(ElementId id) const {
+    const size_t* index = mShapeIds.find(id);
+    if (index == NULL || mShapes[*index].cluster) {
+        cerr << "ERROR: unknown node " << id << "." << endl;
+        return (size_t) -1;
+    }
+    return *index;
+}
+
+Box ComponentRouter::shapeBox(size_t shape) const {
+    if (mShapes[shape].cluster) {
+        const ClusterRecord& cluster = mClusters[mShapes[shape].record];
+        Box box = { cluster.x1, cluster.y1, cluster.x2, cluster.y2 };
+        return box;
+    }
+    const NodeRecord& node = mNodes[mShapes[shape].record];
+    Box box = { node.x1, node.y1, node.x2, node.y2 };
+    return box;
+}
+
+void ComponentRouter::split(double spacing, vector<Group>& groups) const {
+    size_t shapeCount = mShapes.size();
+    DisjointSets sets(shapeCount);
+
+    // shapes connected by an edge are in the same group
+    vector<size_t> sources(mEdges.size(), (size_t) -1);
+    for (size_t i = 0; i < mEdges.size(); ++i) {
+        size_t source = findNode(mEdges[i].source);
+        size_t target = findNode(mEdges[i].target);
+        if (source != (size_t) -1 && target != (size_t) -1) {
+            sources[i] = source;
+            sets.unite(source, target);
+        }
+    }
+
+    // shapes whose enlarged bounding boxes overlap are in the same group; merging
+    // groups enlarges their boxes, so repeat until nothing changes
+    vector<Box> boxes(shapeCount);
+    for (size_t i = 0; i < shapeCount; ++i) {
+        boxes[i] = shapeBox(i).enlarged(spacing);
+    }
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        vector<Box> groupBoxes(shapeCount);
+        vector<bool> isRoot(shapeCount, false);
+        for (size_t i = 0; i < shapeCount; ++i) {
+            size_t root = sets.find(i);
+            if (!isRoot[root]) {
+                isRoot[root] = true;
+                groupBoxes[root] = boxes[i];
+            } else {
+                groupBoxes[root].include(boxes[i]);
+            }
+        }
+
+        // sweep over the boxes sorted by their left side
+        vector<pair<Box, size_t> > sorted;
+        for (size_t i = 0; i < shapeCount; ++i) {
+            if (isRoot[i]) {
+                sorted.push_back(make_pair(groupBoxes[i], i));
+            }
+        }
+        sort(sorted.begin(), sorted.end(), compareX1);
+        vector<pair<Box, size_t> > active;
+        for (size_t i = 0; i < sorted.size(); ++i) {
+            size_t kept = 0;
+            for (size_t j = 0; j < active.size(); ++j) {
+                if (active[j].first.x2 < sorted[i].first.x1) {
+                    continue;
+                }
+                if (active[j].first.overlaps(sorted[i].first)) {
+                    merged |= sets.unite(active[j].second, sorted[i].second);
+                }
+                active[kept++] = active[j];
+            }
+            active.resize(kept);
+            active.push_back(sorted[i]);
+        }
+    }
+
+    // only groups with edges have to be routed
+    vector<size_t> groupOf(shapeCount, (size_t) -1);
+    for (size_t i = 0; i < mEdges.size(); ++i) {
+        if (sources[i] == (size_t) -1) {
+            continue;
+        }
+        size_t root = sets.find(sources[i]);
+        if (groupOf[root] == (size_t) -1) {
+            groupOf[root] = groups.size();
+            groups.push_back(Group());
+        }
+        groups[groupOf[root]].edges.push_back(i);
+    }
+    for (size_t i = 0; i < shapeCount; ++i) {
+        size_t group = groupOf[sets.find(i)];
+        if (group != (size_t) -1) {
+            groups[group].shapes.push_back(i);
+        }
+    }
+    for (size_t i = 0; i < mPorts.size(); ++i) {
+        size_t node = findNode(mPorts[i].node);
+        if (node == (size_t) -1) {
+            continue;
+        }
+        size_t group = groupOf[sets.find(node)];
+        if (group != (size_t) -1) {
+            groups[group].ports.push_back(i);
+        }
+    }
+}
+
+void ComponentRouter::wholeGraph(vector<Group>& groups) const {
+    Group group;
+    for (size_t i = 0; i < mEdges.size(); ++i) {
+        if (findNode(mEdges[i].source) != (size_t) -1 && findNode(mEdges[i].target) != (size_t) -1) {
+            group.edges.push_back(i);
+        }
+    }
+    if (group.edges.empty()) {
+        return;
+    }
+    for (size_t i = 0; i < mShapes.size(); ++i) {
+        group.shapes.push_back(i);
+    }
+    for (size_t i = 0; i < mPorts.size(); ++i) {
+        if (findNode(mPorts[i].node) != (size_t) -1) {
+            group.ports.push_back(i);
+        }
+    }
+    groups.push_back(group);
+}
+
+void ComponentRouter::clip(vector<Group>& groups) const {
+    vector<Box> boxes(mShapes.size());
+    for (size_t i = 0; i < mShapes.size(); ++i) {
+        boxes[i] = shapeBox(i);
+    }
+    SpatialGrid grid;
+    grid.build(boxes);
+
+    // an edge is routed if the box spanned by its end nodes, the corridor of its
+    // route, comes close to the viewport; the obstacles are those near a corridor
+    Box area = mViewport.enlarged(mViewportMargin);
+    Group group;
+    vector<size_t> shapes;
+    for (size_t i = 0; i < mEdges.size(); ++i) {
+        size_t source = findNode(mEdges[i].source);
+        size_t target = findNode(mEdges[i].target);
+        if (source == (size_t) -1 || target == (size_t) -1) {
+            continue;
+        }
+        Box corridor = boxes[source];
+        corridor.include(boxes[target]);
+        corridor = corridor.enlarged(mViewportMargin);
+        if (corridor.overlaps(area)) {
+            group.edges.push_back(i);
+            grid.query(corridor, shapes);
+        }
+    }
+    if (group.edges.empty()) {
+        return;
+    }
+    sort(shapes.begin(), shapes.end());
+    shapes.erase(unique(shapes.begin(), shapes.end()), shapes.end());
+    group.shapes = shapes;
+
+    vector<bool> included(mShapes.size(), false);
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        included[shapes[i]] = true;
+    }
+    for (size_t i = 0; i < mPorts.size(); ++i) {
+        const size_t* shape = mShapeIds.find(mPorts[i].node);
+        if (shape != NULL && included[*shape]) {
+            group.ports.push_back(i);
+        }
+    }
+    groups.push_back(group);
+}
+
+/**
+ * Turns off everything that makes the routing of the router expensive.
+ */
+static void configureCoarse(ControlledRouter* router) {
+    for (int option = 0; option < Avoid::lastRoutingOptionMarker; ++option) {
+        router->setRoutingOption((Avoid::RoutingOption) option, false);
+    }
+    router->setRoutingPenalty(Avoid::crossingPenalty, 0);
+    router->setRoutingPenalty(Avoid::clusterCrossingPenalty, 0);
+    router->setRoutingPenalty(Avoid::fixedSharedPathPenalty, 0);
+    router->setLastPhase(Avoid::TransactionPhaseRouteSearch);
+}
+
+ControlledRouter* ComponentRouter::routeGroup(const Group& group, const RouterSetup& setup,
+        const RoutingControl* control, vector<Hyperedge>& hyperedges) {
+    ControlledRouter* router = new ControlledRouter(setup.connectorType == Avoid::ConnType_PolyLine
+            ? Avoid::PolyLineRouting : Avoid::OrthogonalRouting);
+    setup.config.applyPenalties(router);
+    if (setup.coarse) {
+        configureCoarse(router);
+    } else {
+        setup.config.applyOptions(router);
+    }
+
+    GraphIndex index;
+    for (size_t i = 0; i < group.shapes.size(); ++i) {
+        const Shape& shape = mShapes[group.shapes[i]];
+        if (shape.cluster) {
+            if (!setup.coarse) {
+                ::addCluster(mClusters[shape.record], index, router);
+            }
+        } else {
+            ::addNode(mNodes[shape.record], index, router, setup.direction, setup.pins);
+        }
+    }
+    for (size_t i = 0; i < group.ports.size(); ++i) {
+        ::addPort(mPorts[group.ports[i]], index, router);
+    }
+    // the edges of a net are routed as one hyperedge and get no connector of their own
+    bool nets = setup.hyperedges && !setup.coarse;
+    HyperedgeCollector collector;
+    unordered_map<ElementId, size_t> collected;
+    vector<Avoid::ConnRef*> cons;
+    for (size_t i = 0; i < group.edges.size(); ++i) {
+        const EdgeRecord& edge = mEdges[group.edges[i]];
+        unordered_map<size_t, Avoid::PolyLine>::const_iterator fixed =
+                mFixedRoutes.find(group.edges[i]);
+        if (nets && fixed == mFixedRoutes.end() && collector.add(edge)) {
+            collected[edge.id] = group.edges[i];
+            continue;
+        }
+        Avoid::ConnRef* conn = ::addEdge(edge, setup.connectorType, index, cons, router,
+                setup.direction);
+        if (conn != NULL && fixed != mFixedRoutes.end()) {
+            conn->setFixedRoute(fixed->second);
+        }
+        mConnectors[group.edges[i]] = conn;
+    }
+    if (nets) {
+        size_t first = cons.size();
+        collector.addToRouter(setup.connectorType, index, cons, router, setup.direction);
+        // nets of a single edge have become connectors
+        for (size_t i = first; i < cons.size(); ++i) {
+            mConnectors[collected[cons[i]->id()]] = cons[i];
+        }
+    }
+
+    router->route(control);
+    if (nets) {
+        collector.result(router, hyperedges);
+    }
+    return router;
+}
+
+void ComponentRouter::route(const RouterSetup& setup, double spacing, unsigned int threads,
+        const RoutingControl* control) {
+    vector<Group>& groups = mGroups;
+    if (!mGrouped) {
+        if (mClipped) {
+            clip(groups);
+        } else if (spacing == NO_SPLIT) {
+            wholeGraph(groups);
+        } else {
+            split(spacing, groups);
+        }
+        mGrouped = true;
+    }
+    for (size_t i = 0; i < mRouters.size(); ++i) {
+        delete mRouters[i];
+    }
+
+    // the largest groups first, so that the threads finish at about the same time
+    vector<size_t> order(groups.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    sort(order.begin(), order.end(), [&groups](size_t a, size_t b) {
+        return groups[a].shapes.size() + groups[a].edges.size()
+                > groups[b].shapes.size() + groups[b].edges.size();
+    });
+
+    mRouters.assign(groups.size(), NULL);
+    mConnectors.assign(mEdges.size(), NULL);
+    if (threads == 0) {
+        threads = max(1u, thread::hardware_concurrency());
+    }
+    threads = (unsigned int) min<size_t>(threads, groups.size());
+
+    mGroupHyperedges.assign(groups.size(), vector<Hyperedge>());
+
+    // the allocations of all threads count towards the request
+    MemoryMeter* meter = threadMemoryMeter();
+    atomic<size_t> next(0);
+    auto work = [&]() {
+        MemoryScope scope(meter);
+        for (size_t i = next++; i < order.size(); i = next++) {
+            mRouters[order[i]] = routeGroup(groups[order[i]], setup, control,
+                    mGroupHyperedges[order[i]]);
+        }
+    };
+    vector<thread> workers;
+    for (unsigned int i = 1; i < threads; ++i) {
+        workers.push_back(thread(work));
+    }
+    // the calling thread takes part in the work
+    work();
+    for (size_t i = 0; i < workers.size(); ++i) {
+        workers[i].join();
+    }
+
+    // edges that could not be added are left out of later calls, which would report them again;
+    // the edges of hyperedges have no connector either, but they are only routed by the last call
+    for (size_t i = 0; i < groups.size(); ++i) {
+        vector<size_t>& edges = groups[i].edges;
+        edges.erase(remove_if(edges.begin(), edges.end(), [this](size_t edge) {
+            return mConnectors[edge] == NULL;
+        }), edges.end());
+    }
+}
+
+void ComponentRouter::result(vector<Avoid::ConnRef*>& cons) const {
+    for (size_t i = 0; i < mConnectors.size(); ++i) {
+        if (mConnectors[i] != NULL) {
+            cons.push_back(mConnectors[i]);
+        }
+    }
+}
+
+void ComponentRouter::hyperedges(vector<Hyperedge>& hyperedges) const {
+    for (size_t i = 0; i < mGroupHyperedges.size(); ++i) {
+        hyperedges.insert(hyperedges.end(), mGroupHyperedges[i].begin(),
+                mGroupHyperedges[i].end());
+    }
+}
@@ -0,0 +1,279 @@
+/**
+ * @file    LayoutWriter.cpp
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * The implementation of the layout writer defined in LayoutWriter.h.
+ */
+#include "LayoutWriter.h"
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <thread>
+
+#include "libavoid/libavoid.h"
+#include "MemoryMeter.h"
+
+using namespace std;
+
+/** Powers of ten that are exactly representable as double. */
+const double POW10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9 };
+
+/** Maximum number of decimals tried by the fast path of appendDouble. */
+const int MAX_FAST_DECIMALS = 9;
+
+/** Doubles below this bound represent all integers exactly. */
+const double MAX_EXACT_INTEGER = 9007199254740992.0;
+
+/** High-water mark of the writers used by writeLayout. */
+static size_t layoutHighWaterMark = DEFAULT_HIGH_WATER_MARK;
+
+LayoutWriter::LayoutWriter(size_t highWaterMark) :
+        mHighWaterMark(highWaterMark), mPrecision(EXACT_PRECISION) {
+}
+
+void LayoutWriter::append(const char* text, size_t length) {
+    mBuffer.insert(mBuffer.end(), text, text + length);
+}
+
+void LayoutWriter::appendUnsigned(unsigned long value) {
+    char digits[24];
+    char* begin = digits + sizeof(digits);
+    do {
+        *--begin = (char) ('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    append(begin, digits + sizeof(digits) - begin);
+}
+
+void LayoutWriter::appendDecimal(unsigned long long digits, int decimals, bool negative) {
+    char text[32];
+    char* begin = text + sizeof(text);
+    for (int i = 0; i < decimals; ++i) {
+        *--begin = (char) ('0' + digits % 10);
+        digits /= 10;
+    }
+    if (decimals > 0) {
+        *--begin = '.';
+    }
+    do {
+        *--begin = (char) ('0' + digits % 10);
+        digits /= 10;
+    } while (digits > 0);
+    if (negative) {
+        *--begin = '-';
+    }
+    append(begin, text + sizeof(text) - begin);
+}
+
+void LayoutWriter::appendDouble(double value) {
+    if (value == 0) {
+        append(signbit(value) ? "-0" : "0", signbit(value) ? 2 : 1);
+        return;
+    }
+
+    double magnitude = fabs(value);
+    if (mPrecision != EXACT_PRECISION) {
+        // values too large to be rounded this way have no decimals to drop
+        double scaled = floor(magnitude * POW10[mPrecision] + 0.5);
+        if (scaled < MAX_EXACT_INTEGER) {
+            unsigned long long digits = (unsigned long long) scaled;
+            int decimals = mPrecision;
+            while (decimals > 0 && digits % 10 == 0) {
+                digits /= 10;
+                --decimals;
+            }
+            appendDecimal(digits, decimals, value < 0 && digits > 0);
+            return;
+        }
+    }
+
+    // fast path: the value is an integer with at most a few decimals, which is
+    // the case for almost all coordinates. If the division of the scaled
+    // integer is exact, the decimal reads back to the same double.
+    for (int decimals = 0; decimals <= MAX_FAST_DECIMALS; ++decimals) {
+        double scaled = magnitude * POW10[decimals];
+        if (scaled >= MAX_EXACT_INTEGER) {
+            break;
+        }
+        if (scaled != floor(scaled) || scaled / POW10[decimals] != magnitude) {
+            continue;
+        }
+        appendDecimal((unsigned long long) scaled, decimals, value < 0);
+        return;
+    }
+
+    // general case: 15 significant digits are enough for most doubles, 17 for all
+    char text[32];
+    int length = snprintf(text, sizeof(text), "%.15g", value);
+    if (strtod(text, NULL) != value) {
+        length = snprintf(text, sizeof(text), "%.17g", value);
+    }
+    append(text, length);
+}
+
+void LayoutWriter::emit(ostream& out, bool flush) {
+    if (!mBuffer.empty()) {
+        out.write(&mBuffer[0], mBuffer.size());
+        mBuffer.clear();
+    }
+    if (flush) {
+        out.flush();
+    }
+}
+
+void LayoutWriter::appendRoute(const Avoid::PolyLine& route) {
+    for (size_t j = 0; j < route.ps.size(); ++j) {
+        appendDouble(route.ps[j].x);
+        append(" ", 1);
+        appendDouble(route.ps[j].y);
+        append(" ", 1);
+    }
+}
+
+void LayoutWriter::appendHyperedge(const Hyperedge& hyperedge) {
+    append("HYPEREDGE", 9);
+    for (size_t i = 0; i < hyperedge.edges.size(); ++i) {
+        append(" ", 1);
+        appendUnsigned(hyperedge.edges[i]);
+    }
+    append("=", 1);
+    for (size_t i = 0; i < hyperedge.segments.size(); ++i) {
+        if (i > 0) {
+            append("| ", 2);
+        }
+        appendRoute(hyperedge.segments[i]);
+    }
+    append("\n", 1);
+}
+
+void LayoutWriter::appendEdge(const vector<Avoid::ConnRef*>& cons, const RouteReport* report,
+        size_t i) {
+    append("EDGE ", 5);
+    appendUnsigned(cons[i]->id());
+    if (report != NULL) {
+        const char* status = ROUTE_STATUS_NAMES[report->status[i]];
+        append(" ", 1);
+        append(status, strlen(status));
+    }
+    append("=", 1);
+
+    // Be sure to use #displayRoute() here and not route(), as the
+    // second method only contains the "raw" route, eg, without any
+    // nudging done.
+    appendRoute(report != NULL ? report->route(i, cons[i]) : cons[i]->displayRoute());
+    append("\n", 1);
+}
+
+void LayoutWriter::appendEdges(const vector<Avoid::ConnRef*>& cons, const RouteReport* report,
+        size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+        appendEdge(cons, report, i);
+    }
+}
+
+size_t LayoutWriter::writeEdgesConcurrently(ostream& out, const vector<Avoid::ConnRef*>& cons,
+        const RouteReport* report, unsigned int threads) {
+    // contiguous blocks, so that the buffers are emitted in the order of the edges
+    size_t blockSize = (cons.size() + threads - 1) / threads;
+    vector<LayoutWriter> blocks(threads - 1, LayoutWriter(0));
+
+    // the allocations of all threads count towards the request
+    MemoryMeter* meter = threadMemoryMeter();
+    vector<thread> workers;
+    for (unsigned int i = 1; i < threads; ++i) {
+        LayoutWriter* block = &blocks[i - 1];
+        size_t begin = min(cons.size(), i * blockSize);
+        size_t end = min(cons.size(), begin + blockSize);
+        block->setPrecision(mPrecision);
+        workers.push_back(thread([=, &cons]() {
+            MemoryScope scope(meter);
+            block->appendEdges(cons, report, begin, end);
+        }));
+    }
+    // the calling thread formats the first block
+    appendEdges(cons, report, 0, min(cons.size(), blockSize));
+
+    size_t written = 0;
+    if (mHighWaterMark > 0 && mBuffer.size() >= mHighWaterMark) {
+        written += mBuffer.size();
+        emit(out, true);
+    }
+    for (size_t i = 0; i < workers.size(); ++i) {
+        workers[i].join();
+        vector<char>& block = blocks[i].mBuffer;
+        if (mHighWaterMark > 0 && mBuffer.size() + block.size() >= mHighWaterMark) {
+            // the block is handed to the stream without copying it
+            written += mBuffer.size() + block.size();
+            emit(out, false);
+            blocks[i].emit(out, true);
+        } else {
+            mBuffer.insert(mBuffer.end(), block.begin(), block.end());
+        }
+    }
+    return written;
+}
+
+size_t LayoutWriter::write(ostream& out, const vector<Avoid::ConnRef*>& cons,
+        const RouteReport* report, const vector<Hyperedge>* hyperedges) {
+    mBuffer.clear();
+    append("LAYOUT\n", 7);
+    size_t written = 0;
+
+    unsigned int threads = (unsigned int) min<size_t>(max(1u, thread::hardware_concurrency()),
+            cons.size() / MIN_EDGES_PER_THREAD);
+    if (threads > 1) {
+        written += writeEdgesConcurrently(out, cons, report, threads);
+    } else {
+        for (size_t i = 0; i < cons.size(); ++i) {
+            appendEdge(cons, report, i);
+
+            // let the client start on the edges written so far
+            if (mHighWaterMark > 0 && mBuffer.size() >= mHighWaterMark) {
+                written += mBuffer.size();
+                emit(out, true);
+            }
+        }
+    }
+    for (size_t i = 0; hyperedges != NULL && i < hyperedges->size(); ++i) {
+        appendHyperedge((*hyperedges)[i]);
+        if (mHighWaterMark > 0 && mBuffer.size() >= mHighWaterMark) {
+            written += mBuffer.size();
+            emit(out, true);
+        }
+    }
+
+    append("DONE\n", 5);
+    written += mBuffer.size();
+    emit(out, true);
+    return written;
+}
+
+size_t writeLayout(ostream& out, const vector<Avoid::ConnRef*>& cons,
+        const RouteReport* report, const vector<Hyperedge>* hyperedges, int precision) {
+    // the buffer is reused for all responses of a thread
+    static thread_local LayoutWriter writer;
+    writer.setHighWaterMark(layoutHighWaterMark);
+    writer.setPrecision(precision);
+    return writer.write(out, cons, report, hyperedges);
+}
+
+void setLayoutHighWaterMark(size_t highWaterMark) {
+    layoutHighWaterMark = highWaterMark;
+}
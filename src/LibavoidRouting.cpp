@@ -21,7 +21,6 @@
 
 #include <iostream>
 #include <string>
-#include <sstream>
 #include <algorithm>
 #include <iterator>
 #include <vector>
@@ -29,92 +28,112 @@
 #include <unordered_map>
 
 #include "libavoid/libavoid.h"
+#include "OptionTable.h"
 
 using namespace std;
 
-void tokenize(std::string text, std::vector<string>& tokens) {
-    istringstream iss(text);
-    copy(istream_iterator < string > (iss), istream_iterator<string>(),
-            back_inserter < vector<string> > (tokens));
+bool findPenalty(const char* optionId, Avoid::RoutingParameter& parameter) {
+    int value;
+    if (!findOption(OPTION_PENALTY, optionId, value)) {
+        cerr << "ERROR: unknown penalty " << optionId << "." << endl;
+        return false;
+    }
+    parameter = (Avoid::RoutingParameter) value;
+    return true;
 }
 
-void setPenalty(string optionId, string token, Avoid::Router* router) {
-    if (optionId.rfind("de.cau.cs.kieler.kiml.libavoid.", 0) == 0) {
-        optionId = optionId.substr(31, std::string::npos);
+bool findRoutingOption(const char* optionId, Avoid::RoutingOption& option) {
+    int value;
+    if (!findOption(OPTION_ROUTING, optionId, value)) {
+        cerr << "ERROR: unknown routing option " << optionId << "." << endl;
+        return false;
     }
-    float value = toDouble(token);
-
-    if (optionId == SEGMENT_PENALTY) {
-        router->setRoutingPenalty(Avoid::segmentPenalty, value);
-    } else if (optionId == ANGLE_PENALTY) {
-        router->setRoutingPenalty(Avoid::anglePenalty, value);
-    } else if (optionId == CROSSING_PENALTY) {
-        router->setRoutingPenalty(Avoid::crossingPenalty, value);
-    } else if (optionId == CLUSTER_CROSSING_PENALTY) {
-        router->setRoutingPenalty(Avoid::clusterCrossingPenalty, value);
-    } else if (optionId == FIXED_SHARED_PATH_PENALTY) {
-        router->setRoutingPenalty(Avoid::fixedSharedPathPenalty, value);
-    } else if (optionId == PORT_DIRECTION_PENALTY) {
-        router->setRoutingPenalty(Avoid::portDirectionPenalty, value);
-    } else if (optionId == SHAPE_BUFFER_DISTANCE) {
-        router->setRoutingPenalty(Avoid::shapeBufferDistance, value);
-    } else if (optionId == IDEAL_NUDGING_DISTANCE) {
-        router->setRoutingPenalty(Avoid::idealNudgingDistance, value);
-    } else if (optionId == REVERSE_DIRECTION_PENALTY) {
-        router->setRoutingPenalty(Avoid::reverseDirectionPenalty, value);
-    } else {
-        cerr << "ERROR: unknown penalty " << optionId << "." << endl;
+    option = (Avoid::RoutingOption) value;
+    return true;
+}
+
+/**
+ * Reports an error and returns false if a node or cluster with the given id
+ * exists already.
+ */
+static bool checkUnusedShapeId(ElementId id, const GraphIndex& index) {
+    if (index.nodes.find(id) != NULL || index.clusters.find(id) != NULL) {
+        cerr << "ERROR: duplicate node " << id << "." << endl;
+        return false;
     }
+    return true;
 }
 
-void setOption(string optionId, string token, Avoid::Router* router) {
-    if (optionId.rfind("de.cau.cs.kieler.kiml.libavoid.", 0) == 0) {
-        optionId = optionId.substr(31, std::string::npos);
+/**
+ * Returns the node with the given id, or null after reporting an error if
+ * there is none.
+ */
+static Avoid::ShapeRef* findNode(ElementId id, const GraphIndex& index) {
+    Avoid::ShapeRef* const* shapeRef = index.nodes.find(id);
+    if (shapeRef == NULL) {
+        cerr << "ERROR: unknown node " << id << "." << endl;
+        return NULL;
     }
-    bool value = toBool(token);
-
-    if (optionId == NUDGE_ORTHOGONAL_SEGMENTS) {
-        router->setRoutingOption(Avoid::nudgeOrthogonalSegmentsConnectedToShapes, value);
-    } else if (optionId == IMPROVE_HYPEREDGES) {
-        router->setRoutingOption(Avoid::improveHyperedgeRoutesMovingJunctions, value);
-    } else if (optionId == PENALISE_ORTH_SHATE_PATHS) {
-        router->setRoutingOption(Avoid::penaliseOrthogonalSharedPathsAtConnEnds, value);
-    } else if (optionId == NUDGE_ORTHOGONAL_COLINEAR_SEGMENTS) {
-        router->setRoutingOption(Avoid::nudgeOrthogonalSegmentsConnectedToShapes, value);
-    } else if (optionId == NUDGE_PREPROCESSING) {
-        router->setRoutingOption(Avoid::performUnifyingNudgingPreprocessingStep, value);
-    } else if (optionId == IMPROVE_HYPEREDGES_ADD_DELETE) {
-        router->setRoutingOption(Avoid::improveHyperedgeRoutesMovingAddingAndDeletingJunctions, value);
-    } else if (optionId == NUDGE_SHARED_PATHS_COMMON_ENDPOINT) {
-        router->setRoutingOption(Avoid::nudgeSharedPathsWithCommonEndPoint, value);
-    } else {
-        cerr << "ERROR: unknown routing option " << optionId << "." << endl;
+    return *shapeRef;
+}
+
+/**
+ * Returns the pin class of the port with the given id, or 0 after reporting an
+ * error if there is no such port on the node.
+ */
+static unsigned int findPort(ElementId id, Avoid::ShapeRef* shapeRef, const GraphIndex& index) {
+    const PortPin* port = index.ports.find(id);
+    if (port == NULL) {
+        cerr << "ERROR: unknown port " << id << "." << endl;
+        return 0;
+    }
+    if (port->shape != shapeRef) {
+        cerr << "ERROR: port " << id << " belongs to another node." << endl;
+        return 0;
+    }
+    return port->pinClass;
+}
+
+/**
+ * Returns the number of pins to create on a side for the given number of
+ * port-less edges, and whether they are exclusive.
+ */
+static int pinSlots(int edges, const PinOptions& pins, bool& exclusive) {
+    switch (pins.strategy) {
+    case PINS_SHARED:
+        exclusive = false;
+        return min(edges, 1);
+    case PINS_CAPPED:
+        exclusive = edges <= (int) pins.slots;
+        return min(edges, (int) pins.slots);
+    default:
+        exclusive = true;
+        return edges;
     }
 }
 
-void addNode(vector<string> &tokens, vector<Avoid::ShapeRef*> &shapes, Avoid::Router* router,
-        string direction) {
-    int id = toInt(tokens.at(1));
-    double topLeftX = toDouble(tokens.at(2));
-    double topLeftY = toDouble(tokens.at(3));
-    double bottomRightX = toDouble(tokens.at(4));
-    double bottomRightY = toDouble(tokens.at(5));
-    int portLessIncomingEdges = toInt(tokens[6]);
-    int portLessOutgoingEdges = toInt(tokens[7]);
+void addNode(const NodeRecord& node, GraphIndex& index, Avoid::Router* router,
+        const string& direction, const PinOptions& pins) {
+    int portLessIncomingEdges = node.incoming;
+    int portLessOutgoingEdges = node.outgoing;
+    if (!checkUnusedShapeId(node.id, index)) {
+        return;
+    }
 
     // add the actual rectangle
-    Avoid::Rectangle rectangle(Avoid::Point(topLeftX, topLeftY),
-            Avoid::Point(bottomRightX, bottomRightY));
-    Avoid::ShapeRef *shapeRef = new Avoid::ShapeRef(router, rectangle, id);
+    Avoid::Rectangle rectangle(Avoid::Point(node.x1, node.y1), Avoid::Point(node.x2, node.y2));
+    // libavoid chooses the id, only connector ids are written back
+    Avoid::ShapeRef *shapeRef = new Avoid::ShapeRef(router, rectangle, 0);
 
-    // remember in vector
-    shapes.push_back(shapeRef);
+    // remember in the index
+    index.nodes.insert(node.id, shapeRef);
 
     // create pins for port-less edges
     if (direction == DIRECTION_UNDEFINED) {
 
         // create incoming+outgoing pins on each side of the node
-        int totalPins = portLessIncomingEdges + portLessOutgoingEdges;
+        bool exclusive;
+        int totalPins = pinSlots(portLessIncomingEdges + portLessOutgoingEdges, pins, exclusive);
         if (totalPins > 0) {
             double spacing = 1 / (double) (totalPins + 1);
 
@@ -131,7 +150,7 @@ void addNode(vector<string> &tokens, vector<Avoid::ShapeRef*> &shapes, Avoid::Ro
                     Avoid::ShapeConnectionPin *pin = new Avoid::ShapeConnectionPin(shapeRef,
                             PIN_ARBITRARY, xPos[i] * ((j + 1) * spacing) + xOffset[i],
                             yPos[i] * ((j + 1) * spacing) + yOffset[i], 0.0, connDir[i]);
-                    pin->setExclusive(true);
+                    pin->setExclusive(exclusive);
 
                     /*cout << "Pin at " << xPos[i] * ((j+1) * spacing) + xOffset[i] << " " <<
                      yPos[i] * ((j+1) * spacing) + yOffset[i] << " " <<
@@ -178,58 +197,66 @@ void addNode(vector<string> &tokens, vector<Avoid::ShapeRef*> &shapes, Avoid::Ro
 
         // create the pins
         // incoming
-        if (portLessIncomingEdges > 0) {
-            double incSpacing = 1 / (double) (portLessIncomingEdges + 1);
-            for (int i = 0; i < portLessIncomingEdges; i++) {
+        bool incExclusive;
+        int incPins = pinSlots(portLessIncomingEdges, pins, incExclusive);
+        if (incPins > 0) {
+            double incSpacing = 1 / (double) (incPins + 1);
+            for (int i = 0; i < incPins; i++) {
                 Avoid::ShapeConnectionPin *pin = new Avoid::ShapeConnectionPin(shapeRef,
                         PIN_INCOMING, vertical * ((i + 1) * incSpacing) + right,
                         horizontal * ((i + 1) * incSpacing) + down, 0, connDirIncoming);
-                pin->setExclusive(true);
+                pin->setExclusive(incExclusive);
             }
         }
 
         // outgoing
-        if (portLessOutgoingEdges > 0) {
-            double outSpacing = 1 / (double) (portLessOutgoingEdges + 1);
-            for (int i = 0; i < portLessOutgoingEdges; i++) {
+        bool outExclusive;
+        int outPins = pinSlots(portLessOutgoingEdges, pins, outExclusive);
+        if (outPins > 0) {
+            double outSpacing = 1 / (double) (outPins + 1);
+            for (int i = 0; i < outPins; i++) {
                 Avoid::ShapeConnectionPin *pin = new Avoid::ShapeConnectionPin(shapeRef,
                         PIN_OUTGOING, vertical * ((i + 1) * outSpacing) + left,
                         horizontal * ((i + 1) * outSpacing) + up, 0, connDirOutgoing);
-                pin->setExclusive(true);
+                pin->setExclusive(outExclusive);
             }
         }
     }
 }
 
-void addCluster(vector<string> &tokens, vector<Avoid::ShapeRef*> &shapes, Avoid::Router* router) {
-    int id = toInt(tokens.at(1));
-    double topLeftX = toDouble(tokens.at(2));
-    double topLeftY = toDouble(tokens.at(3));
-    double bottomRightX = toDouble(tokens.at(4));
-    double bottomRightY = toDouble(tokens.at(5));
+void addCluster(const ClusterRecord& cluster, GraphIndex& index, Avoid::Router* router) {
+    if (!checkUnusedShapeId(cluster.id, index)) {
+        return;
+    }
+    double topLeftX = cluster.x1;
+    double topLeftY = cluster.y1;
+    double bottomRightX = cluster.x2;
+    double bottomRightY = cluster.y2;
 
     Avoid::Polygon clusterPoly(4);
     clusterPoly.ps[0] = Avoid::Point(bottomRightX, bottomRightY);  // bottom right
     clusterPoly.ps[1] = Avoid::Point(bottomRightX, topLeftY);      // top right
     clusterPoly.ps[2] = Avoid::Point(topLeftX, topLeftY);          // top left
     clusterPoly.ps[3] = Avoid::Point(topLeftX, bottomRightY);      // bottom left
-    new Avoid::ClusterRef(router, clusterPoly, id);
-
-    shapes.push_back(nullptr); // insert null to avoid out of bounds errors on normal node access
+    Avoid::ClusterRef* clusterRef = new Avoid::ClusterRef(router, clusterPoly, 0);
+    index.clusters.insert(cluster.id, clusterRef);
 }
 
-void addPort(vector<string> &tokens, vector<Avoid::ShapeConnectionPin*> &pins,
-        vector<Avoid::ShapeRef*> &shapes, Avoid::Router* router) {
-    // format: portId nodeId portSide centerX centerYs
-    unsigned int portId = toInt(tokens[1]);
-    unsigned int nodeId = toInt(tokens[2]);
-    string side = tokens[3];
+void addPort(const PortRecord& port, GraphIndex& index, Avoid::Router* router) {
+    Avoid::ShapeRef* shapeRef = findNode(port.node, index);
+    if (shapeRef == NULL) {
+        return;
+    }
+    if (index.ports.find(port.id) != NULL) {
+        cerr << "ERROR: duplicate port " << port.id << "." << endl;
+        return;
+    }
+    unsigned int portId = index.nextPinClass++;
 
     // center positions of the ports
-    double centerX = toDouble(tokens[4]);
-    double centerY = toDouble(tokens[5]);
+    double centerX = port.x;
+    double centerY = port.y;
 
-    Avoid::ShapeRef* shapeRef = shapes[nodeId - 1];
     Avoid::ShapeConnectionPin *pin;
 
     // get the bounding box of the node
@@ -242,54 +269,60 @@ void addPort(vector<string> &tokens, vector<Avoid::ShapeConnectionPin*> &pins,
     double relY = centerY / height;
 
     // create the pin with proper setup
-    if (side == PORT_SIDE_NORTH) {
+    if (port.side == SIDE_NORTH) {
         pin = new Avoid::ShapeConnectionPin(shapeRef, portId, relX, Avoid::ATTACH_POS_TOP, 0,
                 Avoid::ConnDirUp);
-    } else if (side == PORT_SIDE_EAST) {
+    } else if (port.side == SIDE_EAST) {
         pin = new Avoid::ShapeConnectionPin(shapeRef, portId, Avoid::ATTACH_POS_RIGHT, relY, 0,
                 Avoid::ConnDirRight);
-    } else if (side == PORT_SIDE_SOUTH) {
+    } else if (port.side == SIDE_SOUTH) {
         pin = new Avoid::ShapeConnectionPin(shapeRef, portId, relX, Avoid::ATTACH_POS_BOTTOM, 0,
                 Avoid::ConnDirDown);
-    } else { // (side == PORT_SIDE_WEST) {
+    } else { // (port.side == SIDE_WEST) {
         pin = new Avoid::ShapeConnectionPin(shapeRef, portId, Avoid::ATTACH_POS_LEFT, relY, 0,
                 Avoid::ConnDirLeft);
     }
 
     pin->setExclusive(false);
-    pins.push_back(pin);
+    PortPin portPin = { shapeRef, portId };
+    index.ports.insert(port.id, portPin);
 }
 
-void addEdge(vector<string> &tokens, Avoid::ConnType connectorType, vector<Avoid::ShapeRef*> &shapes,
-        vector<Avoid::ConnRef*> &cons, Avoid::Router* router, string direction) {
-    int edgeId = toInt(tokens.at(1));
-    int srcId = toInt(tokens.at(2));
-    int tgtId = toInt(tokens.at(3));
-
+/**
+ * Determines the end points of an edge.
+ *
+ * @return false after reporting an error if the edge refers to an unknown
+ *         node or port
+ */
+static bool edgeEnds(const EdgeRecord& edge, const GraphIndex& index, const string& direction,
+        Avoid::ConnEnd& source, Avoid::ConnEnd& target) {
     // get the shapes for the src and tgt node
-    Avoid::ShapeRef *srcShape = shapes[srcId - 1];
-    Avoid::ShapeRef *tgtShape = shapes[tgtId - 1];
+    Avoid::ShapeRef *srcShape = findNode(edge.source, index);
+    Avoid::ShapeRef *tgtShape = findNode(edge.target, index);
+    if (srcShape == NULL || tgtShape == NULL) {
+        return false;
+    }
 
     // determine the pin locations for this edge
     unsigned int srcPin = PIN_ARBITRARY;
     unsigned int tgtPin = PIN_ARBITRARY;
 
     // differenciate the edge types
-    if (tokens[0] == "PEDGEP") {
-        srcPin = toInt(tokens[4]);
-        tgtPin = toInt(tokens[5]);
-    } else if (tokens[0] == "PEDGE") {
-        srcPin = toInt(tokens[4]);
+    if (edge.hasSourcePort && edge.hasTargetPort) {
+        srcPin = findPort(edge.sourcePort, srcShape, index);
+        tgtPin = findPort(edge.targetPort, tgtShape, index);
+    } else if (edge.hasSourcePort) {
+        srcPin = findPort(edge.sourcePort, srcShape, index);
         // set port-less pin
         if (direction != DIRECTION_UNDEFINED) {
             tgtPin = PIN_INCOMING;
         }
-    } else if (tokens[0] == "EDGEP") {
+    } else if (edge.hasTargetPort) {
         // set port-less pin
         if (direction != DIRECTION_UNDEFINED) {
             srcPin = PIN_OUTGOING;
         }
-        tgtPin = toInt(tokens[5]);
+        tgtPin = findPort(edge.targetPort, tgtShape, index);
     } else {
         // no port on each side
         if (direction != DIRECTION_UNDEFINED) {
@@ -297,61 +330,114 @@ void addEdge(vector<string> &tokens, Avoid::ConnType connectorType, vector<Avoid
             srcPin = PIN_OUTGOING;
         }
     }
+    if (srcPin == 0 || tgtPin == 0) {
+        return false;
+    }
 
     // create endpoints
-    Avoid::ConnEnd srcPt(srcShape, srcPin);
-    Avoid::ConnEnd tgtPt(tgtShape, tgtPin);
+    source = Avoid::ConnEnd(srcShape, srcPin);
+    target = Avoid::ConnEnd(tgtShape, tgtPin);
+    return true;
+}
+
+Avoid::ConnRef* addEdge(const EdgeRecord& edge, Avoid::ConnType connectorType, GraphIndex& index,
+        vector<Avoid::ConnRef*> &cons, Avoid::Router* router, const string& direction) {
+    Avoid::ConnEnd srcPt;
+    Avoid::ConnEnd tgtPt;
+    if (!edgeEnds(edge, index, direction, srcPt, tgtPt)) {
+        return NULL;
+    }
 
     // create the connector
-    Avoid::ConnRef *connRef = new Avoid::ConnRef(router, srcPt, tgtPt, edgeId);
+    Avoid::ConnRef *connRef = new Avoid::ConnRef(router, srcPt, tgtPt, edge.id);
     connRef->setRoutingType(connectorType);
 
     cons.push_back(connRef);
+    return connRef;
 }
 
-// has to be called after Router::processTransaction(), otherwise the ConnEnds for a connection are not set
-void createHyperedges(vector<Avoid::ConnRef*> &cons, Avoid::Router* router) {
-    std::unordered_map<unsigned int, std::vector<Avoid::ConnRef*>> hyperedges;
-    Avoid::HyperedgeRerouter* hyperedgeRerouter = router->hyperedgeRerouter();
-    for (auto* conn : cons) {
-        unsigned int srcId = conn->endpointConnEnds().first.pinClassId();
-        if (srcId == PIN_OUTGOING) {
-            // no port
+bool HyperedgeCollector::add(const EdgeRecord& edge) {
+    if (!edge.hasSourcePort) {
+        return false;
+    }
+    pair<unordered_map<ElementId, size_t>::iterator, bool> net =
+            mNetOfPort.insert(make_pair(edge.sourcePort, mNets.size()));
+    if (net.second) {
+        mNets.push_back(vector<EdgeRecord>());
+    }
+    mNets[net.first->second].push_back(edge);
+    return true;
+}
+
+void HyperedgeCollector::addToRouter(Avoid::ConnType connectorType, GraphIndex& index,
+        vector<Avoid::ConnRef*>& cons, Avoid::Router* router, const string& direction) {
+    if (connectorType != Avoid::ConnType_Orthogonal && !mNets.empty()) {
+        cerr << "WARNING: hyperedges are only routed for orthogonal edges." << endl;
+    }
+    Avoid::HyperedgeRerouter* rerouter = router->hyperedgeRerouter();
+    for (size_t i = 0; i < mNets.size(); ++i) {
+        const vector<EdgeRecord>& net = mNets[i];
+        if (net.size() == 1 || connectorType != Avoid::ConnType_Orthogonal) {
+            for (size_t j = 0; j < net.size(); ++j) {
+                addEdge(net[j], connectorType, index, cons, router, direction);
+            }
             continue;
-        } else if (hyperedges.find(srcId) != hyperedges.end()) {
-            hyperedges[srcId].push_back(conn);
-        } else {
-            hyperedges[srcId] = std::vector<Avoid::ConnRef*>{conn};
         }
-    }
-    for (auto& it: hyperedges) {
-        std::vector<Avoid::ConnRef*> connections = it.second;
-        if (connections.size() > 1) {
-            Avoid::ConnEndList hyperedgeTerminals {connections[0]->endpointConnEnds().first};
-            for (auto& conn : connections) {
-                hyperedgeTerminals.push_back(conn->endpointConnEnds().second);
+
+        // the common source, followed by the targets of all valid edges
+        RegisteredNet registered;
+        Avoid::ConnEnd source;
+        Avoid::ConnEnd target;
+        for (size_t j = 0; j < net.size(); ++j) {
+            if (!edgeEnds(net[j], index, direction, source, target)) {
+                continue;
+            }
+            if (registered.terminals.empty()) {
+                registered.terminals.push_back(source);
             }
-            hyperedgeRerouter->registerHyperedgeForRerouting(hyperedgeTerminals);
+            registered.terminals.push_back(target);
+            registered.edges.push_back(net[j]);
+        }
+        if (registered.edges.size() == 1) {
+            addEdge(registered.edges[0], connectorType, index, cons, router, direction);
+        } else if (registered.edges.size() > 1) {
+            registered.index = rerouter->registerHyperedgeForRerouting(registered.terminals);
+            mRegistered.push_back(registered);
         }
     }
+    mNets.clear();
+    mNetOfPort.clear();
 }
 
-void writeLayout(ostream& out, vector<Avoid::ConnRef*> cons) {
-    out << "LAYOUT" << endl;
-
-    for (std::vector<int>::size_type i = 0; i != cons.size(); i++) {
-
-        out << "EDGE " << cons[i]->id() << "=";
-
-		// Be sure to use #displayRoute() here and not route(), as the 
-		// second method only contains the "raw" route, eg, without any
-		// nudging done.
-        const Avoid::PolyLine route = cons[i]->displayRoute();
-        for (size_t i = 0; i < route.ps.size(); ++i) {
-            out << route.ps[i].x << " " << route.ps[i].y << " ";
+void HyperedgeCollector::result(Avoid::Router* router, vector<Hyperedge>& hyperedges) const {
+    Avoid::HyperedgeRerouter* rerouter = router->hyperedgeRerouter();
+    for (size_t i = 0; i < mRegistered.size(); ++i) {
+        const RegisteredNet& registered = mRegistered[i];
+        hyperedges.push_back(Hyperedge());
+        Hyperedge& hyperedge = hyperedges.back();
+        for (size_t j = 0; j < registered.edges.size(); ++j) {
+            hyperedge.edges.push_back(registered.edges[j].id);
+        }
+        Avoid::HyperedgeNewAndDeletedObjectLists objects =
+                rerouter->newAndDeletedObjectLists(registered.index);
+        for (Avoid::ConnRefList::const_iterator it = objects.newConnectorList.begin();
+                it != objects.newConnectorList.end(); ++it) {
+            hyperedge.segments.push_back((*it)->displayRoute());
+        }
+        if (hyperedge.segments.empty()) {
+            // the transaction was aborted before the tree was built
+            Avoid::Point source = registered.terminals.front().position();
+            Avoid::ConnEndList::const_iterator it = registered.terminals.begin();
+            for (++it; it != registered.terminals.end(); ++it) {
+                Avoid::Point target = it->position();
+                Avoid::PolyLine segment;
+                segment.ps.push_back(source);
+                if (source.x != target.x && source.y != target.y) {
+                    segment.ps.push_back(Avoid::Point(target.x, source.y));
+                }
+                segment.ps.push_back(target);
+                hyperedge.segments.push_back(segment);
+            }
         }
-        out << endl;
     }
-
-    out << "DONE" << endl;
 }
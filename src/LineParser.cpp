@@ -0,0 +1,309 @@
+/**
+ * @file    LineParser.cpp
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * The implementation of the functions defined in LineParser.h.
+ */
+#include "LineParser.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+struct Keyword {
+    const char* name;
+    Command command;
+};
+
+/** The keywords of the protocol, sorted by strcmp for binary search. */
+const Keyword KEYWORDS[] = {
+    { "#", CMD_COMMENT },
+    { "ADD", CMD_ADD },
+    { "BATCH", CMD_BATCH },
+    { "CACHESTATS", CMD_CACHESTATS },
+    { "CANCEL", CMD_CANCEL },
+    { "CLUSTER", CMD_CLUSTER },
+    { "DEBUG", CMD_DEBUG },
+    { "EDGE", CMD_EDGE },
+    { "EDGEP", CMD_EDGEP },
+    { "FIXED", CMD_FIXED },
+    { "GRAPH", CMD_GRAPH },
+    { "GRAPHEND", CMD_GRAPHEND },
+    { "MOVE", CMD_MOVE },
+    { "NODE", CMD_NODE },
+    { "OPTION", CMD_OPTION },
+    { "PEDGE", CMD_PEDGE },
+    { "PEDGEP", CMD_PEDGEP },
+    { "PENALTY", CMD_PENALTY },
+    { "PORT", CMD_PORT },
+    { "PROFILE", CMD_PROFILE },
+    { "REMOVE", CMD_REMOVE },
+    { "REQUEST", CMD_REQUEST },
+    { "RESIZE", CMD_RESIZE },
+    { "ROUTE", CMD_ROUTE },
+    { "ROUTINGOPTION", CMD_ROUTINGOPTION },
+    { "SESSION", CMD_SESSION },
+    { "SESSIONEND", CMD_SESSIONEND },
+    { "SHARED", CMD_SHARED },
+    { "STATS", CMD_STATS },
+    { "VIEWPORT", CMD_VIEWPORT }
+};
+
+const size_t KEYWORD_COUNT = sizeof(KEYWORDS) / sizeof(KEYWORDS[0]);
+
+/** Powers of ten that are exactly representable as double. */
+const double POW10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15 };
+
+/** Maximum number of significant digits read by the fast path of toDouble. */
+const int MAX_FAST_DIGITS = 15;
+
+inline bool isSeparator(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
+inline bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+}
+
+Command lookupCommand(const char* keyword) {
+    size_t low = 0;
+    size_t high = KEYWORD_COUNT;
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+        int cmp = strcmp(keyword, KEYWORDS[mid].name);
+        if (cmp == 0) {
+            return KEYWORDS[mid].command;
+        } else if (cmp < 0) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+    return CMD_UNKNOWN;
+}
+
+size_t LineParser::parse(char* line, size_t length) {
+    mTokens.clear();
+    mFirst = 0;
+    mCommand = CMD_UNKNOWN;
+
+    char* c = line;
+    char* end = c + length;
+    while (c < end) {
+        while (c < end && isSeparator(*c)) {
+            ++c;
+        }
+        if (c == end) {
+            break;
+        }
+        mTokens.push_back(c);
+        while (c < end && !isSeparator(*c)) {
+            ++c;
+        }
+        if (c < end) {
+            *c = '\0';
+            ++c;
+        }
+    }
+
+    if (!mTokens.empty()) {
+        mCommand = lookupCommand(mTokens[0]);
+    }
+    return mTokens.size();
+}
+
+void LineParser::shift() {
+    if (mFirst < mTokens.size()) {
+        ++mFirst;
+    }
+    mCommand = mFirst < mTokens.size() ? lookupCommand(mTokens[mFirst]) : CMD_UNKNOWN;
+}
+
+void LineParser::truncate(size_t size) {
+    if (size < this->size()) {
+        mTokens.resize(mFirst + size);
+    }
+}
+
+bool StringLineSource::nextLine(char*& line, size_t& length) {
+    if (mPos >= mText.size()) {
+        return false;
+    }
+    line = &mText[mPos];
+    size_t lineBreak = mText.find('\n', mPos);
+    if (lineBreak == string::npos) {
+        lineBreak = mText.size();
+    }
+    length = lineBreak - mPos;
+    // the last line is already terminated by the string itself
+    if (lineBreak < mText.size()) {
+        mText[lineBreak] = '\0';
+    }
+    mPos = lineBreak + 1;
+    return true;
+}
+
+bool BufferLineSource::nextLine(char*& line, size_t& length) {
+    if (mData >= mEnd) {
+        return false;
+    }
+    line = mData;
+    char* lineBreak = static_cast<char*>(memchr(mData, '\n', mEnd - mData));
+    length = lineBreak - mData;
+    *lineBreak = '\0';
+    mData = lineBreak + 1;
+    return true;
+}
+
+bool parseNode(const LineParser& line, NodeRecord& node) {
+    // format: NODE id topleft bottomright portLessIncomingEdges portLessOutgoingEdges
+    if (line.size() != 8) {
+        return false;
+    }
+    node.id = toId(line[1]);
+    node.x1 = toDouble(line[2]);
+    node.y1 = toDouble(line[3]);
+    node.x2 = toDouble(line[4]);
+    node.y2 = toDouble(line[5]);
+    node.incoming = toInt(line[6]);
+    node.outgoing = toInt(line[7]);
+    return true;
+}
+
+bool parseCluster(const LineParser& line, ClusterRecord& cluster) {
+    // format: CLUSTER id topleft bottomright
+    if (line.size() != 6) {
+        return false;
+    }
+    cluster.id = toId(line[1]);
+    cluster.x1 = toDouble(line[2]);
+    cluster.y1 = toDouble(line[3]);
+    cluster.x2 = toDouble(line[4]);
+    cluster.y2 = toDouble(line[5]);
+    return true;
+}
+
+bool parsePort(const LineParser& line, PortRecord& port) {
+    // format: PORT portId nodeId portSide centerX centerY
+    if (line.size() != 6) {
+        return false;
+    }
+    port.id = toId(line[1]);
+    port.node = toId(line[2]);
+    if (strcmp(line[3], "NORTH") == 0) {
+        port.side = SIDE_NORTH;
+    } else if (strcmp(line[3], "EAST") == 0) {
+        port.side = SIDE_EAST;
+    } else if (strcmp(line[3], "SOUTH") == 0) {
+        port.side = SIDE_SOUTH;
+    } else {
+        port.side = SIDE_WEST;
+    }
+    port.x = toDouble(line[4]);
+    port.y = toDouble(line[5]);
+    return true;
+}
+
+bool parseEdge(const LineParser& line, EdgeRecord& edge) {
+    // format: EDGE|PEDGEP|PEDGE|EDGEP edgeId srcId tgtId srcPort tgtPort
+    if (line.size() != 6) {
+        return false;
+    }
+    Command type = line.command();
+    edge.id = toInt(line[1]);
+    edge.source = toId(line[2]);
+    edge.target = toId(line[3]);
+    edge.hasSourcePort = type == CMD_PEDGEP || type == CMD_PEDGE;
+    edge.hasTargetPort = type == CMD_PEDGEP || type == CMD_EDGEP;
+    edge.sourcePort = edge.hasSourcePort ? toId(line[4]) : 0;
+    edge.targetPort = edge.hasTargetPort ? toId(line[5]) : 0;
+    return true;
+}
+
+double toDouble(const char* s) {
+    // fast path for plain decimals with few digits: both the digits and the
+    // power of ten are exact, so the division is correctly rounded
+    const char* c = s;
+    bool negative = *c == '-';
+    if (*c == '-' || *c == '+') {
+        ++c;
+    }
+    unsigned long long mantissa = 0;
+    int digits = 0;
+    int scale = 0;
+    while (isDigit(*c)) {
+        mantissa = mantissa * 10 + (*c - '0');
+        ++digits;
+        ++c;
+    }
+    if (*c == '.') {
+        ++c;
+        while (isDigit(*c)) {
+            mantissa = mantissa * 10 + (*c - '0');
+            ++digits;
+            ++scale;
+            ++c;
+        }
+    }
+    if (*c != '\0' || digits == 0 || digits > MAX_FAST_DIGITS) {
+        // exponents, long mantissas, special values and garbage
+        return strtod(s, NULL);
+    }
+    double value = (double) mantissa / POW10[scale];
+    return negative ? -value : value;
+}
+
+int toInt(const char* s) {
+    const char* c = s;
+    bool negative = *c == '-';
+    if (*c == '-' || *c == '+') {
+        ++c;
+    }
+    long long value = 0;
+    while (isDigit(*c)) {
+        value = value * 10 + (*c - '0');
+        ++c;
+    }
+    if (*c != '\0') {
+        return (int) strtol(s, NULL, 10);
+    }
+    return (int) (negative ? -value : value);
+}
+
+ElementId toId(const char* s) {
+    // up to 19 digits cannot overflow
+    const char* c = s;
+    ElementId value = 0;
+    while (isDigit(*c) && c - s < 19) {
+        value = value * 10 + (*c - '0');
+        ++c;
+    }
+    if (*c != '\0' || c == s) {
+        return strtoull(s, NULL, 10);
+    }
+    return value;
+}
+
+bool toBool(const char* s) {
+    return strcmp(s, "true") == 0 || strcmp(s, "TRUE") == 0 || strcmp(s, "True") == 0;
+}
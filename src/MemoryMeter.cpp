@@ -0,0 +1,112 @@
+/**
+ * @file    MemoryMeter.cpp
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * The implementation of the memory accounting defined in MemoryMeter.h,
+ * including the replacement of the global operator new and delete.
+ */
+#include "MemoryMeter.h"
+
+#include <cstdlib>
+#include <new>
+#if defined(__APPLE__)
+#include <malloc/malloc.h>
+#else
+#include <malloc.h>
+#endif
+
+/** the meter of the thread; a plain pointer, so it can be used while the thread starts. */
+static thread_local MemoryMeter* threadMeter = NULL;
+
+MemoryScope::MemoryScope(MemoryMeter* meter) :
+        mPrevious(threadMeter) {
+    threadMeter = meter;
+}
+
+MemoryScope::~MemoryScope() {
+    threadMeter = mPrevious;
+}
+
+MemoryMeter* threadMemoryMeter() {
+    return threadMeter;
+}
+
+/**
+ * @return the size of the block that malloc has handed out, which the delete
+ *         operators are not told
+ */
+static size_t blockSize(void* block) {
+#if defined(__APPLE__)
+    return malloc_size(block);
+#elif defined(_WIN32)
+    return _msize(block);
+#else
+    return malloc_usable_size(block);
+#endif
+}
+
+static void* allocate(size_t size) {
+    void* block = malloc(size > 0 ? size : 1);
+    if (block != NULL && threadMeter != NULL) {
+        threadMeter->allocated(blockSize(block));
+    }
+    return block;
+}
+
+static void release(void* block) {
+    if (block == NULL) {
+        return;
+    }
+    if (threadMeter != NULL) {
+        threadMeter->released(blockSize(block));
+    }
+    free(block);
+}
+
+void* operator new(size_t size) {
+    void* block = allocate(size);
+    if (block == NULL) {
+        throw std::bad_alloc();
+    }
+    return block;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void operator delete(void* block) noexcept {
+    release(block);
+}
+
+void operator delete[](void* block) noexcept {
+    release(block);
+}
+
+void operator delete(void* block, const std::nothrow_t&) noexcept {
+    release(block);
+}
+
+void operator delete[](void* block, const std::nothrow_t&) noexcept {
+    release(block);
+}
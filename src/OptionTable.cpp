@@ -0,0 +1,175 @@
+/**
+ * @file    OptionTable.cpp
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * The implementation of the option table defined in OptionTable.h. The
+ * static assertions check the table against libavoid's enums: every penalty
+ * and routing option, and every layout option, has exactly one entry per
+ * prefix variant, and no two ids share a slot of the hash.
+ */
+#include "OptionTable.h"
+
+#include <cstring>
+#include <cstddef>
+#include <stdint.h>
+
+#include "libavoid/libavoid.h"
+#include "LibavoidRouting.h"
+
+namespace {
+
+/** Prefix of the penalty and routing option ids used by KIELER. */
+#define KIML_LIBAVOID_PREFIX "de.cau.cs.kieler.kiml.libavoid."
+
+/** Prefixes of the layout option ids used by ELK and KIELER. */
+#define ELK_PREFIX "org.eclipse.elk."
+#define KIELER_PREFIX "de.cau.cs.kieler."
+
+struct OptionEntry {
+    const char* id;
+    OptionKind kind;
+    int value;
+};
+
+/* The variants of an id */
+#define PENALTY_ENTRY(id, value) \
+    { id, OPTION_PENALTY, value }, { KIML_LIBAVOID_PREFIX id, OPTION_PENALTY, value }
+#define ROUTING_ENTRY(id, value) \
+    { id, OPTION_ROUTING, value }, { KIML_LIBAVOID_PREFIX id, OPTION_ROUTING, value }
+#define LAYOUT_ENTRY(id, value) \
+    { id, OPTION_LAYOUT, value }, { ELK_PREFIX id, OPTION_LAYOUT, value }, \
+    { KIELER_PREFIX id, OPTION_LAYOUT, value }
+
+/** The number of variants of the ids of each kind. */
+const int PENALTY_VARIANTS = 2;
+const int ROUTING_VARIANTS = 2;
+const int LAYOUT_VARIANTS = 3;
+
+constexpr OptionEntry OPTIONS[] = {
+    PENALTY_ENTRY(SEGMENT_PENALTY, Avoid::segmentPenalty),
+    PENALTY_ENTRY(ANGLE_PENALTY, Avoid::anglePenalty),
+    PENALTY_ENTRY(CROSSING_PENALTY, Avoid::crossingPenalty),
+    PENALTY_ENTRY(CLUSTER_CROSSING_PENALTY, Avoid::clusterCrossingPenalty),
+    PENALTY_ENTRY(FIXED_SHARED_PATH_PENALTY, Avoid::fixedSharedPathPenalty),
+    PENALTY_ENTRY(PORT_DIRECTION_PENALTY, Avoid::portDirectionPenalty),
+    PENALTY_ENTRY(SHAPE_BUFFER_DISTANCE, Avoid::shapeBufferDistance),
+    PENALTY_ENTRY(IDEAL_NUDGING_DISTANCE, Avoid::idealNudgingDistance),
+    PENALTY_ENTRY(REVERSE_DIRECTION_PENALTY, Avoid::reverseDirectionPenalty),
+    ROUTING_ENTRY(NUDGE_ORTHOGONAL_SEGMENTS, Avoid::nudgeOrthogonalSegmentsConnectedToShapes),
+    ROUTING_ENTRY(IMPROVE_HYPEREDGES, Avoid::improveHyperedgeRoutesMovingJunctions),
+    ROUTING_ENTRY(PENALISE_ORTH_SHATE_PATHS, Avoid::penaliseOrthogonalSharedPathsAtConnEnds),
+    ROUTING_ENTRY(NUDGE_ORTHOGONAL_COLINEAR_SEGMENTS,
+            Avoid::nudgeOrthogonalTouchingColinearSegments),
+    ROUTING_ENTRY(NUDGE_PREPROCESSING, Avoid::performUnifyingNudgingPreprocessingStep),
+    ROUTING_ENTRY(IMPROVE_HYPEREDGES_ADD_DELETE,
+            Avoid::improveHyperedgeRoutesMovingAddingAndDeletingJunctions),
+    ROUTING_ENTRY(NUDGE_SHARED_PATHS_COMMON_ENDPOINT, Avoid::nudgeSharedPathsWithCommonEndPoint),
+    LAYOUT_ENTRY(EDGE_ROUTING, LAYOUT_EDGE_ROUTING),
+    LAYOUT_ENTRY(DIRECTION, LAYOUT_DIRECTION),
+    LAYOUT_ENTRY(PIN_STRATEGY, LAYOUT_PIN_STRATEGY),
+    LAYOUT_ENTRY(PIN_SLOTS, LAYOUT_PIN_SLOTS),
+    LAYOUT_ENTRY(ENABLE_HYPEREDGES_FROM_COMMON_SOURCE, LAYOUT_HYPEREDGES),
+    LAYOUT_ENTRY(SPLIT_COMPONENTS, LAYOUT_SPLIT_COMPONENTS),
+    LAYOUT_ENTRY(COMPONENT_SPACING, LAYOUT_COMPONENT_SPACING),
+    LAYOUT_ENTRY(TIME_LIMIT_MS, LAYOUT_TIME_LIMIT),
+    LAYOUT_ENTRY(PROGRESSIVE, LAYOUT_PROGRESSIVE),
+    LAYOUT_ENTRY(MEMORY_LIMIT_MB, LAYOUT_MEMORY_LIMIT),
+    LAYOUT_ENTRY(COORDINATE_PRECISION, LAYOUT_COORDINATE_PRECISION)
+};
+
+constexpr size_t OPTION_COUNT = sizeof(OPTIONS) / sizeof(OPTIONS[0]);
+
+/**
+ * The offset basis of the FNV-1a hash; chosen such that the slots of all ids
+ * are distinct. It has to be searched again if the assertion below fails after
+ * an id was added.
+ */
+constexpr uint32_t HASH_BASIS = 2166143704u;
+
+/** The number of bits of the slot, which are taken from the top of the hash. */
+constexpr int SLOT_BITS = 8;
+
+constexpr size_t SLOT_COUNT = 1 << SLOT_BITS;
+
+constexpr uint32_t hashId(const char* id, uint32_t hash = HASH_BASIS) {
+    return *id == '\0' ? hash : hashId(id + 1, (hash ^ (unsigned char) *id) * 16777619u);
+}
+
+constexpr size_t slotOf(const char* id) {
+    return hashId(id) >> (32 - SLOT_BITS);
+}
+
+/** @return the first entry from the given one on whose id falls into the slot; -1 if none */
+constexpr int entryOfSlot(size_t slot, size_t entry = 0) {
+    return entry == OPTION_COUNT ? -1
+            : slotOf(OPTIONS[entry].id) == slot ? (int) entry : entryOfSlot(slot, entry + 1);
+}
+
+/** @return true if no entry shares its slot with an earlier one */
+constexpr bool slotsDistinct(size_t entry = 0) {
+    return entry == OPTION_COUNT
+            || (entryOfSlot(slotOf(OPTIONS[entry].id)) == (int) entry && slotsDistinct(entry + 1));
+}
+
+/** @return the number of entries of the kind with the value */
+constexpr int entriesOf(OptionKind kind, int value, size_t entry = 0) {
+    return entry == OPTION_COUNT ? 0
+            : (OPTIONS[entry].kind == kind && OPTIONS[entry].value == value)
+                    + entriesOf(kind, value, entry + 1);
+}
+
+/** @return true if all values below the end have the given number of entries */
+constexpr bool complete(OptionKind kind, int variants, int end, int value = 0) {
+    return value == end || (entriesOf(kind, value) == variants
+            && complete(kind, variants, end, value + 1));
+}
+
+static_assert(slotsDistinct(), "the option ids do not form a perfect hash; change HASH_BASIS");
+static_assert(complete(OPTION_PENALTY, PENALTY_VARIANTS, Avoid::lastRoutingParameterMarker),
+        "every penalty needs one entry per prefix variant");
+static_assert(complete(OPTION_ROUTING, ROUTING_VARIANTS, Avoid::lastRoutingOptionMarker),
+        "every routing option needs one entry per prefix variant");
+static_assert(complete(OPTION_LAYOUT, LAYOUT_VARIANTS, LAYOUT_OPTION_COUNT),
+        "every layout option needs one entry per prefix variant");
+static_assert(OPTION_COUNT == PENALTY_VARIANTS * Avoid::lastRoutingParameterMarker
+        + ROUTING_VARIANTS * Avoid::lastRoutingOptionMarker + LAYOUT_VARIANTS * LAYOUT_OPTION_COUNT,
+        "the option table has entries of unknown values");
+
+/* The entry of each slot */
+#define SLOTS_4(slot) entryOfSlot(slot), entryOfSlot(slot + 1), entryOfSlot(slot + 2), \
+    entryOfSlot(slot + 3)
+#define SLOTS_16(slot) SLOTS_4(slot), SLOTS_4(slot + 4), SLOTS_4(slot + 8), SLOTS_4(slot + 12)
+#define SLOTS_64(slot) SLOTS_16(slot), SLOTS_16(slot + 16), SLOTS_16(slot + 32), \
+    SLOTS_16(slot + 48)
+
+constexpr signed char SLOTS[SLOT_COUNT] = { SLOTS_64(0), SLOTS_64(64), SLOTS_64(128),
+        SLOTS_64(192) };
+
+static_assert(sizeof(SLOTS) == SLOT_COUNT && OPTION_COUNT < 128, "invalid slot table");
+
+}
+
+bool findOption(OptionKind kind, const char* optionId, int& value) {
+    uint32_t hash = HASH_BASIS;
+    for (const char* c = optionId; *c != '\0'; ++c) {
+        hash = (hash ^ (unsigned char) *c) * 16777619u;
+    }
+    int entry = SLOTS[hash >> (32 - SLOT_BITS)];
+    if (entry < 0 || OPTIONS[entry].kind != kind || strcmp(OPTIONS[entry].id, optionId) != 0) {
+        return false;
+    }
+    value = OPTIONS[entry].value;
+    return true;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file    Prefork.cpp
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * The implementation of the prefork mode defined in Prefork.h.
+ */
+#include "Prefork.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstring>
+#ifndef _WIN32
+#include <cerrno>
+#include <csignal>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+#ifdef _WIN32
+
+int runPrefork(const string& socketPath, unsigned int workers, ConnectionHandler serve) {
+    cerr << "ERROR: --prefork is not available on Windows." << endl;
+    return 1;
+}
+
+#else
+
+/** set by SIGINT and SIGTERM. */
+static volatile sig_atomic_t stopRequested = 0;
+
+static void requestStop(int) {
+    stopRequested = 1;
+}
+
+/**
+ * Serves one connection after another; never returns.
+ */
+static void runWorker(int listener, ConnectionHandler serve) {
+    signal(SIGINT, SIG_DFL);
+    signal(SIGTERM, SIG_DFL);
+    // a client that goes away must not end the worker
+    signal(SIGPIPE, SIG_IGN);
+
+    while (true) {
+        int connection = accept(listener, NULL, NULL);
+        if (connection < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            cerr << "ERROR: cannot accept a connection: " << strerror(errno) << "." << endl;
+            _exit(1);
+        }
+        serve(connection);
+        close(connection);
+    }
+}
+
+/**
+ * @return the id of the new worker, or -1 if it cannot be created
+ */
+static pid_t startWorker(int listener, ConnectionHandler serve) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        runWorker(listener, serve);
+    } else if (pid < 0) {
+        cerr << "ERROR: cannot start a worker: " << strerror(errno) << "." << endl;
+    }
+    return pid;
+}
+
+int runPrefork(const string& socketPath, unsigned int workers, ConnectionHandler serve) {
+    int listener = listenOnSocket(socketPath);
+    if (listener < 0) {
+        return 1;
+    }
+
+    // without SA_RESTART, waiting for the workers is interrupted by the signals
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = requestStop;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    // anything buffered would be written once per worker
+    cout.flush();
+    vector<pid_t> pids;
+    for (unsigned int i = 0; i < workers; ++i) {
+        pids.push_back(startWorker(listener, serve));
+    }
+
+    while (!stopRequested) {
+        int status;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        for (size_t i = 0; i < pids.size(); ++i) {
+            if (pids[i] == pid && !stopRequested) {
+                cerr << "WARNING: worker " << pid << " ended; starting a new one." << endl;
+                pids[i] = startWorker(listener, serve);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < pids.size(); ++i) {
+        if (pids[i] > 0) {
+            kill(pids[i], SIGTERM);
+            waitpid(pids[i], NULL, 0);
+        }
+    }
+    close(listener);
+    unlink(socketPath.c_str());
+    return 0;
+}
+
+#endif
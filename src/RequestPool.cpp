@@ -0,0 +1,219 @@
+/**
+ * @file    RequestPool.cpp
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * The implementation of the request pool defined in RequestPool.h.
+ */
+#include "RequestPool.h"
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <memory>
+#include <atomic>
+#include <utility>
+
+#include "LineParser.h"
+#include "RoutingControl.h"
+
+using namespace std;
+
+RequestPool::RequestPool(RequestHandler handler, unsigned int workers, ostream& out) :
+        mHandler(handler), mOut(out), mSubmitted(0), mAssigned(workers), mRunning(workers),
+        mClosed(false),
+        mActiveWorkers(workers) {
+    for (unsigned int i = 0; i < workers; ++i) {
+        mWorkers.push_back(thread(&RequestPool::work, this, i));
+    }
+    mWriter = thread(&RequestPool::write, this);
+}
+
+RequestPool::~RequestPool() {
+    {
+        lock_guard<mutex> lock(mMutex);
+        mClosed = true;
+    }
+    mRequestReady.notify_all();
+    for (size_t i = 0; i < mWorkers.size(); ++i) {
+        mWorkers[i].join();
+    }
+    mWriter.join();
+}
+
+void RequestPool::submit(string text) {
+    Request request;
+    request.id = to_string(++mSubmitted);
+    request.text = move(text);
+    request.cancelled = make_shared<atomic<bool> >(false);
+    string session;
+
+    // look for the request id and the session in the header of the request,
+    // copying only the header lines as they are tokenized in place
+    LineParser tokens;
+    string line;
+    for (size_t start = 0; start < request.text.size();) {
+        size_t end = request.text.find('\n', start);
+        if (end == string::npos) {
+            end = request.text.size();
+        }
+        line.assign(request.text, start, end - start);
+        start = end + 1;
+        if (tokens.parse(line) == 0) {
+            continue;
+        }
+        if (tokens.command() == CMD_GRAPH || tokens.command() == CMD_BATCH) {
+            break;
+        }
+        if (tokens.size() < 2) {
+            continue;
+        }
+        if (tokens.command() == CMD_REQUEST) {
+            request.id = tokens[1];
+        } else if (tokens.command() == CMD_SESSION || tokens.command() == CMD_SESSIONEND) {
+            session = tokens[1];
+        }
+    }
+
+    {
+        lock_guard<mutex> lock(mMutex);
+        if (session.empty()) {
+            mShared.push_back(move(request));
+        } else {
+            mAssigned[hash<string>()(session) % mAssigned.size()].push_back(move(request));
+        }
+    }
+    // the request may only be taken by one particular worker
+    mRequestReady.notify_all();
+}
+
+/** The pool, request and output stream of a worker while it handles a request. */
+struct WorkerContext {
+    RequestPool* pool;
+    const string* id;
+    ostringstream* out;
+};
+
+static thread_local WorkerContext workerContext = { NULL, NULL, NULL };
+
+void publishResponse(ostream& out) {
+    if (workerContext.out != &out) {
+        out.flush();
+        return;
+    }
+    workerContext.pool->respond(*workerContext.id, workerContext.out->str());
+    workerContext.out->str("");
+}
+
+void RequestPool::respond(const string& id, string text) {
+    Response response;
+    response.id = id;
+    response.text = move(text);
+    {
+        lock_guard<mutex> lock(mMutex);
+        mResponses.push_back(move(response));
+    }
+    mResponseReady.notify_one();
+}
+
+unsigned int RequestPool::cancel(const string& id) {
+    lock_guard<mutex> lock(mMutex);
+    unsigned int cancelled = 0;
+    auto cancelMatching = [&id, &cancelled](Request& request) {
+        if (request.cancelled && (id.empty() || request.id == id)) {
+            *request.cancelled = true;
+            ++cancelled;
+        }
+    };
+    for_each(mShared.begin(), mShared.end(), cancelMatching);
+    for (size_t i = 0; i < mAssigned.size(); ++i) {
+        for_each(mAssigned[i].begin(), mAssigned[i].end(), cancelMatching);
+    }
+    for_each(mRunning.begin(), mRunning.end(), cancelMatching);
+    return cancelled;
+}
+
+void RequestPool::work(unsigned int worker) {
+    // sessions are owned by the worker that handles all their requests
+    SessionMap sessions;
+
+    while (true) {
+        Request request;
+        {
+            unique_lock<mutex> lock(mMutex);
+            mRequestReady.wait(lock, [this, worker] {
+                return mClosed || !mAssigned[worker].empty() || !mShared.empty();
+            });
+            if (!mAssigned[worker].empty()) {
+                request = move(mAssigned[worker].front());
+                mAssigned[worker].pop_front();
+            } else if (!mShared.empty()) {
+                request = move(mShared.front());
+                mShared.pop_front();
+            } else {
+                break;
+            }
+            // the text is only needed by the worker
+            mRunning[worker].id = request.id;
+            mRunning[worker].cancelled = request.cancelled;
+        }
+
+        StringLineSource in(request.text);
+        ostringstream out;
+        WorkerContext context = { this, &request.id, &out };
+        workerContext = context;
+        setThreadCancelFlag(request.cancelled.get());
+        mHandler(in, out, sessions);
+        setThreadCancelFlag(NULL);
+        workerContext.out = NULL;
+
+        {
+            lock_guard<mutex> lock(mMutex);
+            mRunning[worker] = Request();
+        }
+        respond(request.id, out.str());
+    }
+
+    for (SessionMap::iterator it = sessions.begin(); it != sessions.end(); ++it) {
+        delete it->second;
+    }
+    {
+        lock_guard<mutex> lock(mMutex);
+        --mActiveWorkers;
+    }
+    mResponseReady.notify_one();
+}
+
+void RequestPool::write() {
+    while (true) {
+        Response response;
+        {
+            unique_lock<mutex> lock(mMutex);
+            mResponseReady.wait(lock, [this] {
+                return mActiveWorkers == 0 || !mResponses.empty();
+            });
+            if (mResponses.empty()) {
+                break;
+            }
+            response = move(mResponses.front());
+            mResponses.pop_front();
+        }
+
+        mOut << "RESPONSE " << response.id << "\n" << response.text;
+        mOut.flush();
+    }
+}
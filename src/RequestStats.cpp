@@ -0,0 +1,78 @@
+/**
+ * @file    RequestStats.cpp
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * The implementation of the statistics functions defined in RequestStats.h.
+ */
+#include "RequestStats.h"
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <mutex>
+
+using namespace std;
+
+/** Names of the phases in the STATS block. */
+const char* const PHASE_NAMES[PHASE_COUNT] = { "parseMs", "shapesMs", "pinsMs", "connectorsMs",
+        "routingMs", "hyperedgesMs", "outputMs" };
+
+/** Serializes the appends to side files of concurrent requests. */
+static mutex statsFileMutex;
+
+static double toMillis(StatsClock::duration duration) {
+    return chrono::duration<double, milli>(duration).count();
+}
+
+void writeStats(ostream& out, const RequestStats& stats) {
+    out << "STATS\n";
+    if (!stats.requestId.empty()) {
+        out << "request " << stats.requestId << "\n";
+    }
+    for (int i = 0; i < PHASE_COUNT; ++i) {
+        out << PHASE_NAMES[i] << " " << toMillis(stats.elapsed[i]) << "\n";
+    }
+    out << "totalMs " << toMillis(StatsClock::now() - stats.start) << "\n";
+    out << "shapes " << stats.shapes << "\n";
+    out << "pins " << stats.pins << "\n";
+    out << "connectors " << stats.connectors << "\n";
+    out << "routePoints " << stats.routePoints << "\n";
+    out << "bytesIn " << stats.bytesIn << "\n";
+    out << "bytesOut " << stats.bytesOut << "\n";
+    if (stats.memory != NULL) {
+        // the meter may have seen more releases than allocations
+        out << "memoryPeakBytes " << stats.memory->peak() << "\n";
+    }
+    // a distinct terminator, so that the block is not taken for the end of a response
+    out << "STATSEND\n";
+}
+
+void reportStats(ostream& out, const RequestStats& stats) {
+    if (!stats.enabled) {
+        return;
+    }
+    if (stats.file.empty()) {
+        writeStats(out, stats);
+        out.flush();
+        return;
+    }
+
+    lock_guard<mutex> lock(statsFileMutex);
+    ofstream file(stats.file.c_str(), ios::out | ios::app);
+    writeStats(file, stats);
+    if (!file) {
+        cerr << "ERROR: could not write statistics to " << stats.file << "." << endl;
+    }
+}
@@ -0,0 +1,159 @@
+/**
+ * @file    RequestTrace.cpp
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * The implementation of the request traces defined in RequestTrace.h.
+ */
+#include "RequestTrace.h"
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <chrono>
+#include <cstring>
+#include <climits>
+#include <algorithm>
+
+using namespace std;
+
+/** The largest header line of a record that is read. */
+const int MAX_HEADER_LENGTH = 4096;
+
+TraceWriter::TraceWriter() :
+        mFile(NULL) {
+}
+
+TraceWriter::~TraceWriter() {
+    if (mFile != NULL) {
+        gzclose(mFile);
+    }
+}
+
+bool TraceWriter::open(const string& path) {
+    // a new gzip member is appended to an existing trace
+    mFile = gzopen(path.c_str(), "ab");
+    if (mFile == NULL) {
+        cerr << "ERROR: cannot write trace " << path << "." << endl;
+        return false;
+    }
+    return true;
+}
+
+void TraceWriter::write(const TraceRecord& record) {
+    ostringstream header;
+    header << "RECORD " << record.request.size() << " " << hex << record.hash << dec;
+    for (int i = 0; i < PHASE_COUNT; ++i) {
+        header << " " << record.phaseMs[i];
+    }
+    if (!record.id.empty()) {
+        header << " " << record.id;
+    }
+    header << "\n";
+    string text = header.str();
+
+    lock_guard<mutex> lock(mMutex);
+    gzwrite(mFile, text.data(), (unsigned int) text.size());
+    // requests are limited by the chunk buffer, but may exceed what gzwrite takes at once
+    for (size_t done = 0; done < record.request.size();) {
+        unsigned int count = (unsigned int) min<size_t>(record.request.size() - done, INT_MAX);
+        if (gzwrite(mFile, record.request.data() + done, count) <= 0) {
+            cerr << "ERROR: could not write to the trace." << endl;
+            return;
+        }
+        done += count;
+    }
+    gzflush(mFile, Z_SYNC_FLUSH);
+}
+
+TraceReader::TraceReader() :
+        mFile(NULL) {
+}
+
+TraceReader::~TraceReader() {
+    if (mFile != NULL) {
+        gzclose(mFile);
+    }
+}
+
+bool TraceReader::open(const string& path) {
+    mFile = gzopen(path.c_str(), "rb");
+    if (mFile == NULL) {
+        cerr << "ERROR: cannot read trace " << path << "." << endl;
+        return false;
+    }
+    return true;
+}
+
+bool TraceReader::next(TraceRecord& record) {
+    char line[MAX_HEADER_LENGTH];
+    if (gzgets(mFile, line, sizeof(line)) == NULL) {
+        return false;
+    }
+    istringstream header(line);
+    string keyword;
+    size_t size = 0;
+    header >> keyword >> size >> hex >> record.hash >> dec;
+    for (int i = 0; i < PHASE_COUNT; ++i) {
+        header >> record.phaseMs[i];
+    }
+    if (keyword != "RECORD" || !header) {
+        cerr << "ERROR: invalid trace record." << endl;
+        return false;
+    }
+    record.id.clear();
+    header >> record.id;
+
+    record.request.resize(size);
+    for (size_t done = 0; done < size;) {
+        unsigned int count = (unsigned int) min<size_t>(size - done, INT_MAX);
+        int read = gzread(mFile, &record.request[done], count);
+        if (read <= 0) {
+            cerr << "ERROR: incomplete trace record." << endl;
+            return false;
+        }
+        done += read;
+    }
+    return true;
+}
+
+uint64_t hashResponse(const string& response) {
+    uint64_t hash = 14695981039346656037ULL;
+    bool inStats = false;
+    for (size_t begin = 0; begin < response.size();) {
+        size_t end = response.find('\n', begin);
+        end = end == string::npos ? response.size() : end + 1;
+        const char* line = response.data() + begin;
+        size_t length = end - begin;
+        if (length == 6 && strncmp(line, "STATS\n", 6) == 0) {
+            inStats = true;
+        }
+        if (!inStats) {
+            for (size_t i = 0; i < length; ++i) {
+                hash = (hash ^ (unsigned char) line[i]) * 1099511628211ULL;
+            }
+        } else if (length == 9 && strncmp(line, "STATSEND\n", 9) == 0) {
+            inStats = false;
+        }
+        begin = end;
+    }
+    return hash;
+}
+
+void recordStats(const RequestStats& stats, TraceRecord& record) {
+    record.id = stats.requestId;
+    for (int i = 0; i < PHASE_COUNT; ++i) {
+        record.phaseMs[i] = chrono::duration<double, milli>(stats.elapsed[i]).count();
+    }
+}
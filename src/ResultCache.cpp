@@ -0,0 +1,191 @@
+/**
+ * @file    ResultCache.cpp
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * The implementation of the result cache defined in ResultCache.h. A cache
+ * file consists of the line CANONICAL {bytes}, the canonical form of the
+ * request and the response.
+ */
+#include "ResultCache.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstdio>
+#include <thread>
+#include <stdint.h>
+
+#include "LineParser.h"
+
+using namespace std;
+
+/** Parameters of the 64 bit FNV-1a hash, which is stable across platforms and runs. */
+const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+const uint64_t FNV_PRIME = 1099511628211ULL;
+
+ResultCache::ResultCache(size_t maxBytes, const string& directory) :
+        mMaxBytes(maxBytes), mBytes(0), mDirectory(directory), mHits(0), mMisses(0) {
+}
+
+CacheUse ResultCache::canonicalKey(const string& request, string& key, string& canonical) {
+    // the lines are tokenized in place
+    string text(request);
+    StringLineSource lines(text);
+    LineParser tokens;
+    char* line;
+    size_t length;
+
+    canonical.clear();
+    while (lines.nextLine(line, length)) {
+        if (tokens.parse(line, length) == 0) {
+            continue;
+        }
+        switch (tokens.command()) {
+        case CMD_CACHESTATS:
+            return CACHE_STATS;
+        case CMD_SESSION:
+        case CMD_SESSIONEND:
+        case CMD_MOVE:
+        case CMD_RESIZE:
+        case CMD_REMOVE:
+        case CMD_DEBUG:
+        case CMD_STATS:
+        case CMD_PROFILE:
+        case CMD_CANCEL:
+            // depends on earlier requests or has side effects
+            return CACHE_BYPASS;
+        case CMD_COMMENT:
+        case CMD_REQUEST:
+            // does not affect the result
+            continue;
+        default:
+            break;
+        }
+
+        // the canonical line consists of the tokens separated by single blanks
+        for (size_t i = 0; i < tokens.size(); ++i) {
+            canonical += tokens[i];
+            canonical += i + 1 < tokens.size() ? ' ' : '\n';
+        }
+    }
+
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (size_t i = 0; i < canonical.size(); ++i) {
+        hash = (hash ^ (unsigned char) canonical[i]) * FNV_PRIME;
+    }
+    char buffer[40];
+    snprintf(buffer, sizeof(buffer), "%016llx-%llx", (unsigned long long) hash,
+            (unsigned long long) canonical.size());
+    key = buffer;
+    return CACHE_USE;
+}
+
+string ResultCache::path(const string& key) const {
+    return mDirectory + "/" + key + ".layout";
+}
+
+void ResultCache::insert(const string& key, const string& canonical, const string& response) {
+    size_t size = canonical.size() + response.size();
+    if (size > mMaxBytes || mIndex.find(key) != mIndex.end()) {
+        return;
+    }
+    Entry entry = { key, canonical, response };
+    mEntries.push_front(entry);
+    mIndex[key] = mEntries.begin();
+    mBytes += size;
+    while (mBytes > mMaxBytes) {
+        mBytes -= mEntries.back().canonical.size() + mEntries.back().response.size();
+        mIndex.erase(mEntries.back().key);
+        mEntries.pop_back();
+    }
+}
+
+bool ResultCache::readFile(const string& key, const string& canonical, string& response) const {
+    ifstream file(path(key).c_str(), ios::in | ios::binary);
+    string keyword;
+    size_t size = 0;
+    if (!(file >> keyword >> size) || keyword != "CANONICAL" || size != canonical.size()
+            || file.get() != '\n') {
+        return false;
+    }
+    string stored(size, '\0');
+    if (!file.read(&stored[0], size) || stored != canonical) {
+        return false;
+    }
+    ostringstream content;
+    content << file.rdbuf();
+    response = content.str();
+    return true;
+}
+
+bool ResultCache::lookup(const string& key, const string& canonical, string& response) {
+    {
+        lock_guard<mutex> lock(mMutex);
+        unordered_map<string, EntryList::iterator>::iterator it = mIndex.find(key);
+        // a different request with the same key is a miss
+        if (it != mIndex.end() && it->second->canonical == canonical) {
+            // move to the front of the LRU list
+            mEntries.splice(mEntries.begin(), mEntries, it->second);
+            response = it->second->response;
+            ++mHits;
+            return true;
+        }
+    }
+
+    if (!mDirectory.empty() && readFile(key, canonical, response)) {
+        lock_guard<mutex> lock(mMutex);
+        insert(key, canonical, response);
+        ++mHits;
+        return true;
+    }
+
+    lock_guard<mutex> lock(mMutex);
+    ++mMisses;
+    return false;
+}
+
+void ResultCache::store(const string& key, const string& canonical, const string& response) {
+    {
+        lock_guard<mutex> lock(mMutex);
+        insert(key, canonical, response);
+    }
+
+    if (!mDirectory.empty()) {
+        // write to a temporary file first, so that no partial file is read
+        string target = path(key);
+        ostringstream temporary;
+        temporary << target << ".tmp" << this_thread::get_id();
+        ofstream file(temporary.str().c_str(), ios::out | ios::binary | ios::trunc);
+        file << "CANONICAL " << canonical.size() << "\n";
+        file.write(canonical.data(), canonical.size());
+        file.write(response.data(), response.size());
+        file.close();
+        if (!file) {
+            cerr << "ERROR: could not write cache file " << target << "." << endl;
+            remove(temporary.str().c_str());
+        } else if (rename(temporary.str().c_str(), target.c_str()) != 0) {
+            // another worker has stored the same response in the meantime
+            remove(temporary.str().c_str());
+        }
+    }
+}
+
+void ResultCache::writeStats(ostream& out) {
+    lock_guard<mutex> lock(mMutex);
+    out << "CACHESTATS hits " << mHits << " misses " << mMisses << " entries "
+            << mEntries.size() << " bytes " << mBytes << "\n";
+    out.flush();
+}
@@ -0,0 +1,124 @@
+/**
+ * @file    RouterConfig.cpp
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * The implementation of the router configurations defined in RouterConfig.h.
+ */
+#include "RouterConfig.h"
+
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "libavoid/libavoid.h"
+#include "LibavoidRouting.h"
+#include "LineParser.h"
+
+using namespace std;
+
+RouterConfig::RouterConfig() :
+        connectorType(Avoid::ConnType_Orthogonal) {
+    clear();
+}
+
+void RouterConfig::clear() {
+    for (int i = 0; i < Avoid::lastRoutingParameterMarker; ++i) {
+        penaltySet[i] = false;
+        penalties[i] = 0;
+    }
+    for (int i = 0; i < Avoid::lastRoutingOptionMarker; ++i) {
+        optionSet[i] = false;
+        options[i] = false;
+    }
+}
+
+bool RouterConfig::setPenalty(const char* optionId, const char* token, Avoid::Router* router) {
+    Avoid::RoutingParameter parameter;
+    if (!findPenalty(optionId, parameter)) {
+        return false;
+    }
+    // libavoid has always been passed the penalties as floats
+    float value = toDouble(token);
+    penaltySet[parameter] = true;
+    penalties[parameter] = value;
+    if (router != NULL) {
+        router->setRoutingPenalty(parameter, value);
+    }
+    return true;
+}
+
+bool RouterConfig::setOption(const char* optionId, const char* token, Avoid::Router* router) {
+    Avoid::RoutingOption option;
+    if (!findRoutingOption(optionId, option)) {
+        return false;
+    }
+    optionSet[option] = true;
+    options[option] = toBool(token);
+    if (router != NULL) {
+        router->setRoutingOption(option, options[option]);
+    }
+    return true;
+}
+
+void RouterConfig::merge(const RouterConfig& other) {
+    for (int i = 0; i < Avoid::lastRoutingParameterMarker; ++i) {
+        if (other.penaltySet[i]) {
+            penaltySet[i] = true;
+            penalties[i] = other.penalties[i];
+        }
+    }
+    for (int i = 0; i < Avoid::lastRoutingOptionMarker; ++i) {
+        if (other.optionSet[i]) {
+            optionSet[i] = true;
+            options[i] = other.options[i];
+        }
+    }
+}
+
+void RouterConfig::applyPenalties(Avoid::Router* router) const {
+    for (int i = 0; i < Avoid::lastRoutingParameterMarker; ++i) {
+        if (penaltySet[i]) {
+            router->setRoutingPenalty((Avoid::RoutingParameter) i, penalties[i]);
+        }
+    }
+}
+
+void RouterConfig::applyOptions(Avoid::Router* router) const {
+    for (int i = 0; i < Avoid::lastRoutingOptionMarker; ++i) {
+        if (optionSet[i]) {
+            router->setRoutingOption((Avoid::RoutingOption) i, options[i]);
+        }
+    }
+}
+
+/** the profiles by their names. */
+static map<string, RouterConfig> profiles;
+/** guards the profiles. */
+static mutex profilesMutex;
+
+void defineProfile(const string& name, const RouterConfig& config) {
+    lock_guard<mutex> lock(profilesMutex);
+    profiles[name] = config;
+}
+
+bool findProfile(const string& name, RouterConfig& config) {
+    lock_guard<mutex> lock(profilesMutex);
+    map<string, RouterConfig>::const_iterator it = profiles.find(name);
+    if (it == profiles.end()) {
+        return false;
+    }
+    config = it->second;
+    return true;
+}
@@ -0,0 +1,147 @@
+/**
+ * @file    RouterSession.cpp
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * The implementation of the functions defined in RouterSession.h.
+ */
+#include "RouterSession.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "libavoid/libavoid.h"
+
+using namespace std;
+
+/**
+ * Returns the node with the given id, or null after reporting an error if
+ * there is none.
+ */
+static Avoid::ShapeRef* findNode(RouterSession& session, ElementId nodeId) {
+    Avoid::ShapeRef** shapeRef = session.index.nodes.find(nodeId);
+    if (shapeRef == NULL) {
+        cerr << "ERROR: unknown node " << nodeId << "." << endl;
+        return NULL;
+    }
+    return *shapeRef;
+}
+
+/**
+ * Deletes the connector of the given edge from the router and the session.
+ */
+static void deleteEdge(RouterSession& session, unordered_map<unsigned int, SessionEdge>::iterator edge) {
+    Avoid::ConnRef* conn = edge->second.conn;
+    session.cons.erase(std::remove(session.cons.begin(), session.cons.end(), conn), session.cons.end());
+    session.router->deleteConnector(conn);
+    session.edges.erase(edge);
+}
+
+void addSessionNode(const NodeRecord& node, RouterSession& session) {
+    addNode(node, session.index, session.router, session.direction, session.pins);
+}
+
+Avoid::ConnRef* addSessionEdge(const EdgeRecord& edge, RouterSession& session) {
+    if (findNode(session, edge.source) == NULL || findNode(session, edge.target) == NULL) {
+        return NULL;
+    }
+
+    // an edge that is sent again replaces the previous one
+    unordered_map<unsigned int, SessionEdge>::iterator existing = session.edges.find(edge.id);
+    if (existing != session.edges.end()) {
+        deleteEdge(session, existing);
+    }
+
+    Avoid::ConnRef* conn = addEdge(edge, session.connectorType, session.index, session.cons,
+            session.router, session.direction);
+    if (conn == NULL) {
+        return NULL;
+    }
+
+    SessionEdge& sessionEdge = session.edges[edge.id];
+    sessionEdge.conn = conn;
+    sessionEdge.srcNode = edge.source;
+    sessionEdge.tgtNode = edge.target;
+    return conn;
+}
+
+void moveNode(ElementId nodeId, double dx, double dy, RouterSession& session) {
+    Avoid::ShapeRef* shapeRef = findNode(session, nodeId);
+    if (shapeRef == NULL) {
+        return;
+    }
+    session.router->moveShape(shapeRef, dx, dy);
+}
+
+void resizeNode(ElementId nodeId, double x1, double y1, double x2, double y2,
+        RouterSession& session) {
+    Avoid::ShapeRef* shapeRef = findNode(session, nodeId);
+    if (shapeRef == NULL) {
+        return;
+    }
+    Avoid::Rectangle rectangle(Avoid::Point(x1, y1), Avoid::Point(x2, y2));
+    session.router->moveShape(shapeRef, rectangle);
+}
+
+void removeNode(ElementId nodeId, RouterSession& session) {
+    Avoid::ShapeRef* shapeRef = findNode(session, nodeId);
+    if (shapeRef == NULL) {
+        return;
+    }
+    // connectors must not outlive the shapes they are attached to
+    unordered_map<unsigned int, SessionEdge>::iterator edge = session.edges.begin();
+    while (edge != session.edges.end()) {
+        unordered_map<unsigned int, SessionEdge>::iterator next = edge;
+        ++next;
+        if (edge->second.srcNode == nodeId || edge->second.tgtNode == nodeId) {
+            deleteEdge(session, edge);
+        }
+        edge = next;
+    }
+    // the pins of the shape are deleted together with it
+    vector<ElementId> ports;
+    session.index.ports.forEach([&ports, shapeRef](ElementId id, const PortPin& port) {
+        if (port.shape == shapeRef) {
+            ports.push_back(id);
+        }
+    });
+    for (size_t i = 0; i < ports.size(); ++i) {
+        session.index.ports.erase(ports[i]);
+    }
+    session.router->deleteShape(shapeRef);
+    session.index.nodes.erase(nodeId);
+}
+
+void removeEdge(unsigned int edgeId, RouterSession& session) {
+    unordered_map<unsigned int, SessionEdge>::iterator edge = session.edges.find(edgeId);
+    if (edge == session.edges.end()) {
+        cerr << "ERROR: unknown edge " << edgeId << "." << endl;
+        return;
+    }
+    deleteEdge(session, edge);
+}
+
+void collectChangedConnectors(RouterSession& session, vector<Avoid::ConnRef*>& changed) {
+    for (size_t i = 0; i < session.cons.size(); ++i) {
+        Avoid::ConnRef* conn = session.cons[i];
+        SessionEdge& edge = session.edges[conn->id()];
+        const Avoid::PolyLine& route = conn->displayRoute();
+        if (route.ps != edge.route.ps) {
+            edge.route = route;
+            changed.push_back(conn);
+        }
+    }
+}
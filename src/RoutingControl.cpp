@@ -0,0 +1,192 @@
+/**
+ * @file    RoutingControl.cpp
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * The implementation of the request control defined in RoutingControl.h.
+ */
+#include "RoutingControl.h"
+
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+#include "libavoid/libavoid.h"
+#include "LineParser.h"
+
+using namespace std;
+
+const char* const ROUTE_STATUS_NAMES[] = { "COMPLETE", "PARTIAL", "FALLBACK" };
+
+RoutingControl::RoutingControl() :
+        mStart(chrono::steady_clock::now()), mDeadline(mStart), mLimited(false),
+        mCancelled(false), mCancelFlag(NULL), mMemoryLimit(0), mMeter(NULL) {
+}
+
+void RoutingControl::setTimeLimit(unsigned int milliseconds) {
+    mLimited = milliseconds > 0;
+    mDeadline = mStart + chrono::milliseconds(milliseconds);
+}
+
+bool RoutingControl::expired() const {
+    return cancelled() || (mLimited && chrono::steady_clock::now() >= mDeadline)
+            || overMemoryLimit();
+}
+
+ControlledRouter::ControlledRouter(unsigned int flags) :
+        Avoid::Router(flags), mControl(NULL), mAborted(false), mLastPhase(0) {
+}
+
+bool ControlledRouter::route(const RoutingControl* control) {
+    mControl = control;
+    mAborted = false;
+    processTransaction();
+    // the control belongs to the request, whereas a session's router lives on
+    mControl = NULL;
+    return !mAborted;
+}
+
+bool ControlledRouter::shouldContinueTransactionWithProgress(unsigned int elapsedTime,
+        unsigned int phaseNumber, unsigned int totalPhases, double proportion) {
+    if (mLastPhase > 0 && phaseNumber > mLastPhase) {
+        return false;
+    }
+    if (mControl != NULL && mControl->expired()) {
+        mAborted = true;
+        return false;
+    }
+    return Avoid::Router::shouldContinueTransactionWithProgress(elapsedTime, phaseNumber,
+            totalPhases, proportion);
+}
+
+bool RouteReport::complete() const {
+    for (size_t i = 0; i < status.size(); ++i) {
+        if (status[i] != ROUTE_COMPLETE) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void reportRoutes(const vector<Avoid::ConnRef*>& cons, RouteReport& report) {
+    report.status.assign(cons.size(), ROUTE_COMPLETE);
+    report.fallbacks.assign(cons.size(), Avoid::PolyLine());
+    for (size_t i = 0; i < cons.size(); ++i) {
+        if (!static_cast<ControlledRouter*>(cons[i]->router())->aborted()) {
+            continue;
+        }
+        if (cons[i]->displayRoute().ps.size() >= 2) {
+            report.status[i] = ROUTE_PARTIAL;
+            continue;
+        }
+        // connect the end points directly, with one bend for orthogonal connectors
+        report.status[i] = ROUTE_FALLBACK;
+        pair<Avoid::ConnEnd, Avoid::ConnEnd> ends = cons[i]->endpointConnEnds();
+        Avoid::Point source = ends.first.position();
+        Avoid::Point target = ends.second.position();
+        vector<Avoid::Point>& points = report.fallbacks[i].ps;
+        points.push_back(source);
+        if (cons[i]->routingType() == Avoid::ConnType_Orthogonal && source.x != target.x
+                && source.y != target.y) {
+            points.push_back(Avoid::Point(target.x, source.y));
+        }
+        points.push_back(target);
+    }
+}
+
+/** the registered requests. */
+static vector<pair<string, RoutingControl*> > runningRequests;
+/** guards the registered requests. */
+static mutex runningRequestsMutex;
+
+void registerRequest(const string& id, RoutingControl* control) {
+    lock_guard<mutex> lock(runningRequestsMutex);
+    runningRequests.push_back(make_pair(id, control));
+}
+
+void unregisterRequest(RoutingControl* control) {
+    lock_guard<mutex> lock(runningRequestsMutex);
+    size_t kept = 0;
+    for (size_t i = 0; i < runningRequests.size(); ++i) {
+        if (runningRequests[i].second != control) {
+            runningRequests[kept++] = runningRequests[i];
+        }
+    }
+    runningRequests.resize(kept);
+}
+
+unsigned int cancelRequests(const string& id) {
+    lock_guard<mutex> lock(runningRequestsMutex);
+    unsigned int cancelled = 0;
+    for (size_t i = 0; i < runningRequests.size(); ++i) {
+        if (id.empty() || runningRequests[i].first == id) {
+            runningRequests[i].second->cancel();
+            ++cancelled;
+        }
+    }
+    return cancelled;
+}
+
+/** the flag that cancels the requests of a thread. */
+static thread_local const atomic<bool>* cancelFlag = NULL;
+
+void setThreadCancelFlag(const atomic<bool>* flag) {
+    cancelFlag = flag;
+}
+
+const atomic<bool>* threadCancelFlag() {
+    return cancelFlag;
+}
+
+/**
+ * Reads the commands of the control channel until its end.
+ */
+static void readControlChannel(const string& path, unsigned int (*cancel)(const string&)) {
+    bool reopen = false;
+#ifndef _WIN32
+    struct stat info;
+    reopen = stat(path.c_str(), &info) == 0 && S_ISFIFO(info.st_mode);
+#endif
+    LineParser tokens;
+    do {
+        ifstream in(path.c_str());
+        if (!in) {
+            cerr << "ERROR: cannot open control channel " << path << "." << endl;
+            return;
+        }
+        for (string line; getline(in, line);) {
+            tokens.parse(line);
+            if (tokens.empty() || tokens.command() == CMD_COMMENT) {
+                continue;
+            }
+            if (tokens.command() != CMD_CANCEL) {
+                cerr << "ERROR: invalid control command " << tokens[0] << "." << endl;
+            } else if (cancel(tokens.size() >= 2 ? tokens[1] : "") == 0) {
+                cerr << "WARNING: no running request to cancel." << endl;
+            }
+        }
+    } while (reopen);
+}
+
+void startControlChannel(const string& path, unsigned int (*cancel)(const string&)) {
+    // the thread ends with the process
+    thread(readControlChannel, path, cancel).detach();
+}
@@ -0,0 +1,674 @@
+/**
+ * @file    RoutingRequest.cpp
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * The implementation of the routing request defined in RoutingRequest.h.
+ */
+#include "RoutingRequest.h"
+
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+
+#include "libavoid/libavoid.h"
+#include "LibavoidRouting.h"
+#include "OptionTable.h"
+
+using namespace std;
+
+/** Upper bound of each count of a GRAPH size hint. */
+static const size_t MAX_SIZE_HINT = 1 << 22;
+
+/**
+ * Converts a FIXED line to the edge and its route, which is given by at least
+ * two points behind the edge declaration.
+ */
+static bool parseFixedEdge(LineParser& tokens, EdgeRecord& edge, Avoid::PolyLine& route) {
+    tokens.shift();
+    Command type = tokens.command();
+    if ((type != CMD_EDGE && type != CMD_PEDGEP && type != CMD_PEDGE && type != CMD_EDGEP)
+            || tokens.size() < 10 || tokens.size() % 2 != 0) {
+        return false;
+    }
+    route.ps.resize((tokens.size() - 6) / 2);
+    for (size_t i = 0; i < route.ps.size(); ++i) {
+        route.ps[i] = Avoid::Point(toDouble(tokens[6 + 2 * i]), toDouble(tokens[7 + 2 * i]));
+    }
+    tokens.truncate(6);
+    return parseEdge(tokens, edge);
+}
+
+/**
+ * Converts the tokens of a line to a record; the conversion is part of the
+ * parse phase.
+ */
+template<class Record>
+static bool timedParse(bool (*parse)(const LineParser&, Record&), const LineParser& tokens,
+        Record& record, RequestStats& stats) {
+    PhaseTimer timer(stats, PHASE_PARSE);
+    return parse(tokens, record);
+}
+
+RoutingRequest::RoutingRequest(SessionMap& sessions) :
+        mMemoryScope(&mMemory), mSessions(sessions), mRequestSession(&threadArena()), mSession(&mRequestSession),
+        mNamed(false), mUpdate(false), mClosed(false), mDebug(false), mGraphDecl(false),
+        mHyperedges(false), mSplit(false), mProgressive(false), mClipped(false),
+        mComponentSpacing(DEFAULT_COMPONENT_SPACING), mPrecision(EXACT_PRECISION),
+        mComponents(&threadArena()) {
+    mControl.watch(threadCancelFlag());
+    mControl.measure(&mMemory);
+    mStats.memory = &mMemory;
+}
+
+RoutingRequest::~RoutingRequest() {
+    unregisterRequest(&mControl);
+}
+
+void RoutingRequest::ensureRouter() {
+    // router is initialized upon receiption of the edge routing option or the first element
+    if (mSession->router == NULL) {
+        mSession->router = new ControlledRouter(Avoid::OrthogonalRouting);
+    }
+}
+
+void RoutingRequest::createRouter(Avoid::ConnType connectorType) {
+    delete mSession->router;
+    mSetup.config.clear();
+    mSession->router = new ControlledRouter(connectorType == Avoid::ConnType_PolyLine
+            ? Avoid::PolyLineRouting : Avoid::OrthogonalRouting);
+    mSession->connectorType = connectorType;
+}
+
+void RoutingRequest::useProfile(const char* name) {
+    RouterConfig profile;
+    if (!findProfile(name, profile)) {
+        cerr << "ERROR: unknown profile " << name << "." << endl;
+        return;
+    }
+    if (mGraphDecl) {
+        cerr << "WARNING: profiles should not be used after GRAPH declaration" << endl;
+    }
+    // the router is only replaced if the profile needs another kind of routing
+    if (mSession->router == NULL || profile.connectorType != mSession->connectorType) {
+        if (mUpdate) {
+            cerr << "WARNING: ignoring the " << EDGE_ROUTING << " of profile " << name
+                    << " for an existing session." << endl;
+        } else if (mStats.shapes + mStats.pins + mStats.connectors > 0) {
+            cerr << "WARNING: ignoring the " << EDGE_ROUTING << " of profile " << name
+                    << " after graph elements." << endl;
+        } else {
+            if (mSession->router != NULL) {
+                cerr << "WARNING: discarding previous options due to profile " << name << "."
+                        << endl;
+            }
+            createRouter(profile.connectorType);
+        }
+    }
+    ensureRouter();
+    profile.applyPenalties(mSession->router);
+    profile.applyOptions(mSession->router);
+    mSetup.config.merge(profile);
+}
+
+void RoutingRequest::beginElement() {
+    ensureRouter();
+    if (!mGraphDecl) {
+        cerr << "ERROR: missing declaration of GRAPH" << endl;
+        mGraphDecl = true;
+    }
+}
+
+bool RoutingRequest::handleLine(LineParser& tokens) {
+    if (tokens.empty()) {
+        return true;
+    }
+
+    // explicit additions to a session and edges to be routed are plain element declarations
+    if ((tokens.command() == CMD_ADD || tokens.command() == CMD_ROUTE) && tokens.size() >= 2) {
+        tokens.shift();
+    }
+
+    switch (tokens.command()) {
+    case CMD_SESSION:
+        if (tokens.size() < 2) {
+            cerr << "ERROR: invalid session format" << endl;
+        } else if (mNamed || mSession->router != NULL || mGraphDecl) {
+            cerr << "ERROR: SESSION must be declared before all other commands" << endl;
+        } else {
+            SessionMap::iterator it = mSessions.find(tokens[1]);
+            if (it != mSessions.end()) {
+                mSession = it->second;
+                mUpdate = true;
+            } else {
+                mSession = new RouterSession();
+                mSessions[tokens[1]] = mSession;
+            }
+            mNamed = true;
+        }
+        break;
+
+    case CMD_SESSIONEND:
+        if (tokens.size() < 2) {
+            cerr << "ERROR: invalid session format" << endl;
+        } else {
+            SessionMap::iterator it = mSessions.find(tokens[1]);
+            if (it != mSessions.end()) {
+                // the session may be the one of this request
+                if (it->second == mSession) {
+                    mSession = &mRequestSession;
+                    mNamed = false;
+                    mUpdate = false;
+                }
+                delete it->second;
+                mSessions.erase(it);
+            } else {
+                cerr << "ERROR: unknown session " << tokens[1] << "." << endl;
+            }
+        }
+        // nothing is routed for the request
+        mClosed = true;
+        return false;
+
+    case CMD_PENALTY:
+        if (tokens.size() < 3) {
+            cerr << "ERROR: invalid penalty format" << endl;
+            break;
+        }
+        ensureRouter();
+        if (mGraphDecl) {
+            cerr << "WARNING: penalties should not be specified after GRAPH declaration" << endl;
+        }
+
+        /* Penalties */
+        mSetup.config.setPenalty(tokens[1], tokens[2], mSession->router);
+        break;
+
+    case CMD_ROUTINGOPTION:
+        if (tokens.size() < 3) {
+            cerr << "ERROR: invalid routing option format" << endl;
+            break;
+        }
+        ensureRouter();
+        if (mGraphDecl) {
+            cerr << "WARNING: routing options should not be specified after GRAPH declaration" << endl;
+        }
+
+        /* Routing options */
+        mSetup.config.setOption(tokens[1], tokens[2], mSession->router);
+        break;
+
+    case CMD_PROFILE:
+        // format: PROFILE define|use name
+        if (tokens.size() < 3) {
+            cerr << "ERROR: invalid profile format" << endl;
+        } else if (strcmp(tokens[1], "define") == 0) {
+            RouterConfig config = mSetup.config;
+            config.connectorType = mSession->connectorType;
+            defineProfile(tokens[2], config);
+        } else if (strcmp(tokens[1], "use") == 0) {
+            useProfile(tokens[2]);
+        } else {
+            cerr << "ERROR: invalid profile format" << endl;
+        }
+        break;
+
+    case CMD_OPTION: {
+        if (tokens.size() < 3) {
+            cerr << "ERROR: invalid option format" << endl;
+            break;
+        }
+        if (mGraphDecl) {
+            cerr << "WARNING: options should not be specified after GRAPH declaration" << endl;
+        }
+        const char* optionId = tokens[1];
+        int option;
+        if (!findOption(OPTION_LAYOUT, optionId, option)) {
+            cerr << "ERROR: unknown option " << optionId << "." << endl;
+            break;
+        }
+
+        /* General options */
+        switch (option) {
+        case LAYOUT_EDGE_ROUTING:
+        case LAYOUT_DIRECTION:
+        case LAYOUT_PIN_STRATEGY:
+        case LAYOUT_PIN_SLOTS:
+            if (mUpdate) {
+                cerr << "WARNING: ignoring " << optionId << " for an existing session." << endl;
+            } else if (option == LAYOUT_EDGE_ROUTING) {
+                if (mSession->router) {
+                    // possibly delete an old router
+                    cerr << "WARNING: discarding previous options due to " << EDGE_ROUTING
+                            << " declaration." << endl;
+                }
+                // edge routing, default orthogonal
+                createRouter(strcmp(tokens[2], EDGE_ROUTING_POLYLINE) == 0
+                        ? Avoid::ConnType_PolyLine : Avoid::ConnType_Orthogonal);
+            } else if (option == LAYOUT_DIRECTION) {
+                // layout direction
+                mSession->direction = tokens[2];
+            } else if (option == LAYOUT_PIN_STRATEGY) {
+                if (strcmp(tokens[2], PIN_STRATEGY_EXCLUSIVE) == 0) {
+                    mSession->pins.strategy = PINS_EXCLUSIVE;
+                } else if (strcmp(tokens[2], PIN_STRATEGY_SHARED) == 0) {
+                    mSession->pins.strategy = PINS_SHARED;
+                } else if (strcmp(tokens[2], PIN_STRATEGY_CAPPED) == 0) {
+                    mSession->pins.strategy = PINS_CAPPED;
+                } else {
+                    cerr << "ERROR: unknown pin strategy " << tokens[2] << "." << endl;
+                }
+            } else {
+                int slots = toInt(tokens[2]);
+                if (slots < 1) {
+                    cerr << "ERROR: invalid number of pin slots " << tokens[2] << "." << endl;
+                } else {
+                    mSession->pins.slots = slots;
+                }
+            }
+            break;
+
+        case LAYOUT_HYPEREDGES:
+            // the nets are collected while the edges are read
+            if (mNamed) {
+                cerr << "WARNING: ignoring " << optionId << " for a session." << endl;
+            } else if (mStats.connectors > 0) {
+                cerr << "WARNING: ignoring " << optionId << " after edges." << endl;
+            } else {
+                mHyperedges = toBool(tokens[2]);
+            }
+            break;
+
+        case LAYOUT_SPLIT_COMPONENTS:
+        case LAYOUT_PROGRESSIVE:
+            // the elements are collected instead of being added to the router
+            if (mNamed) {
+                cerr << "WARNING: ignoring " << optionId << " for a session." << endl;
+            } else if (mStats.shapes + mStats.pins + mStats.connectors > 0) {
+                cerr << "WARNING: ignoring " << optionId << " after graph elements." << endl;
+            } else if (option == LAYOUT_SPLIT_COMPONENTS) {
+                mSplit = toBool(tokens[2]);
+            } else {
+                mProgressive = toBool(tokens[2]);
+            }
+            break;
+
+        case LAYOUT_COMPONENT_SPACING:
+            mComponentSpacing = toDouble(tokens[2]);
+            break;
+
+        case LAYOUT_MEMORY_LIMIT: {
+            int limit = toInt(tokens[2]);
+            if (limit < 0) {
+                cerr << "ERROR: invalid memory limit " << tokens[2] << "." << endl;
+            } else {
+                mControl.setMemoryLimit((size_t) limit << 20);
+            }
+            break;
+        }
+
+        case LAYOUT_TIME_LIMIT: {
+            int limit = toInt(tokens[2]);
+            if (limit < 0) {
+                cerr << "ERROR: invalid time limit " << tokens[2] << "." << endl;
+            } else {
+                mControl.setTimeLimit(limit);
+            }
+            break;
+        }
+
+        case LAYOUT_COORDINATE_PRECISION: {
+            int precision = toInt(tokens[2]);
+            if (precision < 0 || precision > MAX_PRECISION) {
+                cerr << "ERROR: invalid coordinate precision " << tokens[2] << "." << endl;
+            } else {
+                mPrecision = precision;
+            }
+            break;
+        }
+        }
+        break;
+    }
+
+    case CMD_NODE: {
+        // format:
+        // id topleft bottomright portLessIncomingEdges portLessOutgoingEdges
+        NodeRecord node;
+        if (!timedParse(parseNode, tokens, node, mStats)) {
+            cerr << "ERROR: invalid node format" << endl;
+        } else {
+            handleNode(node);
+        }
+        break;
+    }
+
+    case CMD_CLUSTER: {
+        // format:
+        // id topleft bottomright
+        ClusterRecord cluster;
+        if (!timedParse(parseCluster, tokens, cluster, mStats)) {
+            cerr << "ERROR: invalid cluster format" << endl;
+        } else {
+            handleCluster(cluster);
+        }
+        break;
+    }
+
+    case CMD_PORT: {
+        // format: portId nodeId portSide centerX centerYs
+        PortRecord port;
+        if (!timedParse(parsePort, tokens, port, mStats)) {
+            cerr << "ERROR: invalid port format" << endl;
+        } else {
+            handlePort(port);
+        }
+        break;
+    }
+
+    case CMD_EDGE:
+    case CMD_PEDGEP:
+    case CMD_PEDGE:
+    case CMD_EDGEP: {
+        // format: edgeId srcId tgtId srcPort tgtPort
+        EdgeRecord edge;
+        if (!timedParse(parseEdge, tokens, edge, mStats)) {
+            cerr << "ERROR: invalid edge format" << endl;
+        } else {
+            handleEdge(edge);
+        }
+        break;
+    }
+
+    case CMD_FIXED: {
+        // format: FIXED {edge type} edgeId srcId tgtId srcPort tgtPort x1 y1 x2 y2 ...
+        EdgeRecord edge;
+        Avoid::PolyLine route;
+        bool valid;
+        {
+            PhaseTimer timer(mStats, PHASE_PARSE);
+            valid = parseFixedEdge(tokens, edge, route);
+        }
+        if (!valid) {
+            cerr << "ERROR: invalid fixed edge format" << endl;
+        } else {
+            handleEdge(edge, &route);
+        }
+        break;
+    }
+
+    case CMD_MOVE:
+    case CMD_RESIZE:
+    case CMD_REMOVE:
+        if (!mUpdate) {
+            cerr << "ERROR: " << tokens[0] << " requires an existing SESSION" << endl;
+        // format: MOVE nodeId dx dy
+        } else if (tokens.command() == CMD_MOVE && tokens.size() == 4) {
+            moveNode(toId(tokens[1]), toDouble(tokens[2]), toDouble(tokens[3]), *mSession);
+        // format: RESIZE nodeId topleft bottomright
+        } else if (tokens.command() == CMD_RESIZE && tokens.size() == 6) {
+            resizeNode(toId(tokens[1]), toDouble(tokens[2]), toDouble(tokens[3]),
+                    toDouble(tokens[4]), toDouble(tokens[5]), *mSession);
+        // format: REMOVE NODE|EDGE id
+        } else if (tokens.command() == CMD_REMOVE && tokens.size() == 3
+                && lookupCommand(tokens[1]) == CMD_NODE) {
+            removeNode(toId(tokens[2]), *mSession);
+        } else if (tokens.command() == CMD_REMOVE && tokens.size() == 3
+                && lookupCommand(tokens[1]) == CMD_EDGE) {
+            removeEdge(toInt(tokens[2]), *mSession);
+        } else {
+            cerr << "ERROR: invalid " << tokens[0] << " format" << endl;
+        }
+        break;
+
+		case CMD_DEBUG:
+			mDebug = true;
+			break;
+
+    case CMD_REQUEST:
+        // the request id is used to tag responses in concurrent mode
+        if (tokens.size() >= 2) {
+            mStats.requestId = tokens[1];
+            registerRequest(mStats.requestId, &mControl);
+        }
+        break;
+
+    case CMD_CANCEL:
+        // format: CANCEL [request id]; only requests of other threads can be running
+        if (cancelRequests(tokens.size() >= 2 ? tokens[1] : "") == 0) {
+            cerr << "WARNING: no running request to cancel." << endl;
+        }
+        break;
+
+    case CMD_VIEWPORT:
+        // format: VIEWPORT x1 y1 x2 y2 [margin]
+        if (tokens.size() < 5) {
+            cerr << "ERROR: invalid viewport format" << endl;
+        } else if (mNamed) {
+            cerr << "WARNING: ignoring VIEWPORT for a session." << endl;
+        } else if (mStats.shapes + mStats.pins + mStats.connectors > 0) {
+            cerr << "WARNING: ignoring VIEWPORT after graph elements." << endl;
+        } else {
+            Box viewport = { toDouble(tokens[1]), toDouble(tokens[2]), toDouble(tokens[3]),
+                    toDouble(tokens[4]) };
+            mComponents.setViewport(viewport,
+                    tokens.size() >= 6 ? toDouble(tokens[5]) : DEFAULT_VIEWPORT_MARGIN);
+            mClipped = true;
+        }
+        break;
+
+    case CMD_STATS:
+        // format: STATS [file]
+        mStats.enable();
+        if (tokens.size() >= 2) {
+            mStats.file = tokens[1];
+        }
+        break;
+
+    case CMD_GRAPH:
+        if (mGraphDecl) {
+            cerr << "ERROR: duplicate declaration of GRAPH" << endl;
+        }
+        mGraphDecl = true;
+        if (tokens.size() == 4) {
+            // size hint: GRAPH {nodes} {edges} {ports}
+            reserve(toId(tokens[1]), toId(tokens[2]), toId(tokens[3]));
+        }
+        break;
+
+    case CMD_GRAPHEND:
+        if (!mGraphDecl) {
+            cerr << "ERROR: missing declaration of GRAPH" << endl;
+        }
+        return false;
+
+    case CMD_CACHESTATS:
+        cerr << "ERROR: the result cache is not enabled" << endl;
+        break;
+
+    case CMD_COMMENT:
+        // ignore it
+        break;
+
+    default:
+        cerr << "ERROR: invalid command " << tokens[0] << "." << endl;
+        break;
+    }
+    return true;
+}
+
+void RoutingRequest::reserve(size_t nodes, size_t edges, size_t ports) {
+    // a hint must not make a request reserve more than it could use
+    nodes = min(nodes, MAX_SIZE_HINT);
+    edges = min(edges, MAX_SIZE_HINT);
+    ports = min(ports, MAX_SIZE_HINT);
+    if (collected()) {
+        mComponents.reserve(nodes, edges, ports);
+    } else {
+        mSession->index.nodes.reserve(nodes);
+        mSession->index.ports.reserve(ports);
+        mSession->cons.reserve(mSession->cons.size() + edges);
+    }
+}
+
+void RoutingRequest::handleNode(const NodeRecord& node) {
+    PhaseTimer timer(mStats, PHASE_SHAPES);
+    ++mStats.shapes;
+    beginElement();
+    if (collected()) {
+        mComponents.addNode(node);
+    } else if (mNamed) {
+        addSessionNode(node, *mSession);
+    } else {
+        addNode(node, mSession->index, mSession->router, mSession->direction, mSession->pins);
+    }
+}
+
+void RoutingRequest::handleCluster(const ClusterRecord& cluster) {
+    PhaseTimer timer(mStats, PHASE_SHAPES);
+    ++mStats.shapes;
+    beginElement();
+    if (collected()) {
+        mComponents.addCluster(cluster);
+    } else {
+        addCluster(cluster, mSession->index, mSession->router);
+    }
+}
+
+void RoutingRequest::handlePort(const PortRecord& port) {
+    PhaseTimer timer(mStats, PHASE_PINS);
+    ++mStats.pins;
+    beginElement();
+    if (collected()) {
+        mComponents.addPort(port);
+    } else {
+        addPort(port, mSession->index, mSession->router);
+    }
+}
+
+void RoutingRequest::handleEdge(const EdgeRecord& edge, const Avoid::PolyLine* fixedRoute) {
+    PhaseTimer timer(mStats, PHASE_CONNECTORS);
+    ++mStats.connectors;
+    beginElement();
+    Avoid::ConnRef* conn = NULL;
+    if (collected()) {
+        mComponents.addEdge(edge, fixedRoute);
+    } else if (mNamed) {
+        conn = addSessionEdge(edge, *mSession);
+    } else if (!mHyperedges || fixedRoute != NULL || !mNets.add(edge)) {
+        conn = addEdge(edge, mSession->connectorType, mSession->index, mSession->cons,
+                mSession->router, mSession->direction);
+    }
+    // a fixed route is left alone by the routing, but other routes avoid crossing it
+    if (conn != NULL && fixedRoute != NULL) {
+        conn->setFixedRoute(*fixedRoute);
+    }
+}
+
+bool RoutingRequest::routeCoarse() {
+    if (mClosed || mSession->router == NULL || !mProgressive) {
+        return false;
+    }
+    // shared pins are found faster and look the same at a glance
+    mSetup.connectorType = mSession->connectorType;
+    mSetup.direction = mSession->direction;
+    mSetup.pins.strategy = PINS_SHARED;
+    mSetup.hyperedges = false;
+    mSetup.coarse = true;
+    PhaseTimer timer(mStats, PHASE_ROUTING);
+    mComponents.route(mSetup, mSplit ? mComponentSpacing : NO_SPLIT, 0, &mControl);
+    return true;
+}
+
+bool RoutingRequest::route() {
+    if (mClosed || mSession->router == NULL) {
+        return false;
+    }
+
+    if (collected()) {
+        // each group gets its own router, configured like the request's router
+        mSetup.connectorType = mSession->connectorType;
+        mSetup.direction = mSession->direction;
+        mSetup.pins = mSession->pins;
+        mSetup.hyperedges = mHyperedges;
+        mSetup.coarse = false;
+        PhaseTimer timer(mStats, PHASE_ROUTING);
+        mComponents.route(mSetup, mSplit ? mComponentSpacing : NO_SPLIT, 0, &mControl);
+        if (mDebug) {
+            cerr << "WARNING: no debug output for " << (mClipped ? "VIEWPORT" : mSplit
+                    ? SPLIT_COMPONENTS : PROGRESSIVE) << "." << endl;
+        }
+        return true;
+    }
+
+    if (mHyperedges) {
+        // the nets are routed in the same transaction as all other edges
+        PhaseTimer timer(mStats, PHASE_HYPEREDGES);
+        mNets.addToRouter(mSession->connectorType, mSession->index, mSession->cons,
+                mSession->router, mSession->direction);
+    }
+    {
+        // perform edge routing; for an existing session libavoid only reroutes
+        // the connectors affected by the changes of this request
+        PhaseTimer timer(mStats, PHASE_ROUTING);
+        if (!mSession->router->route(&mControl)) {
+            cerr << "WARNING: routing aborted " << (mControl.cancelled() ? "by cancellation"
+                    : mControl.overMemoryLimit() ? "after the memory limit"
+                    : "after the time limit") << "." << endl;
+        }
+    }
+    if (mHyperedges) {
+        PhaseTimer timer(mStats, PHASE_HYPEREDGES);
+        mNets.result(mSession->router, mHyperedgeRoutes);
+    }
+
+	if (mDebug) {
+		mSession->router->outputInstanceToSVG();
+	}
+    return true;
+}
+
+void RoutingRequest::result(vector<Avoid::ConnRef*>& cons) {
+    size_t first = cons.size();
+    if (collected()) {
+        mComponents.result(cons);
+    } else if (mNamed) {
+        collectChangedConnectors(*mSession, cons);
+    } else {
+        cons.insert(cons.end(), mSession->cons.begin(), mSession->cons.end());
+    }
+    // the client knows the fixed routes already
+    cons.erase(remove_if(cons.begin() + first, cons.end(), [](Avoid::ConnRef* conn) {
+        return conn->hasFixedRoute();
+    }), cons.end());
+    if (mStats.enabled) {
+        for (size_t i = first; i < cons.size(); ++i) {
+            mStats.routePoints += cons[i]->displayRoute().ps.size();
+        }
+    }
+}
+
+void RoutingRequest::hyperedges(vector<Hyperedge>& hyperedges) const {
+    if (collected()) {
+        mComponents.hyperedges(hyperedges);
+    } else {
+        hyperedges.insert(hyperedges.end(), mHyperedgeRoutes.begin(), mHyperedgeRoutes.end());
+    }
+}
+
+bool RoutingRequest::report(const vector<Avoid::ConnRef*>& cons, RouteReport& report) {
+    reportRoutes(cons, report);
+    return mControl.limited() || mControl.cancelled();
+}
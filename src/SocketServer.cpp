@@ -0,0 +1,237 @@
+/**
+ * @file    SocketServer.cpp
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * The implementation of the socket mode defined in SocketServer.h.
+ */
+#include "SocketServer.h"
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstring>
+#include <cerrno>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <csignal>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+/** The size of the buffer of a connection's output. */
+const size_t OUTPUT_BUFFER_SIZE = 1 << 16;
+
+#ifdef _WIN32
+
+int listenOnSocket(const string& path) {
+    cerr << "ERROR: sockets are not available on Windows." << endl;
+    return -1;
+}
+
+int runSocketServer(const string& path, ConnectionHandler serve) {
+    return listenOnSocket(path) < 0 ? 1 : 0;
+}
+
+SharedRegion::SharedRegion() :
+        mData(NULL), mSize(0) {
+}
+
+SharedRegion::~SharedRegion() {
+}
+
+bool SharedRegion::map(const string& path) {
+    cerr << "ERROR: shared memory is not available on Windows." << endl;
+    return false;
+}
+
+#else
+
+int listenOnSocket(const string& path) {
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        cerr << "ERROR: socket path " << path << " is too long." << endl;
+        return -1;
+    }
+    strcpy(address.sun_path, path.c_str());
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(path.c_str());
+    if (listener < 0 || bind(listener, (sockaddr*) &address, sizeof(address)) != 0
+            || listen(listener, SOMAXCONN) != 0) {
+        cerr << "ERROR: cannot listen on " << path << ": " << strerror(errno) << "." << endl;
+        if (listener >= 0) {
+            close(listener);
+        }
+        return -1;
+    }
+    return listener;
+}
+
+/** set by SIGINT and SIGTERM. */
+static volatile sig_atomic_t stopRequested = 0;
+
+static void requestStop(int) {
+    stopRequested = 1;
+}
+
+static void serveConnection(int fd, ConnectionHandler serve) {
+    serve(fd);
+    close(fd);
+}
+
+int runSocketServer(const string& path, ConnectionHandler serve) {
+    int listener = listenOnSocket(path);
+    if (listener < 0) {
+        return 1;
+    }
+
+    // without SA_RESTART, accept() is interrupted by the signals
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = requestStop;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    // a client that goes away must not end the server
+    signal(SIGPIPE, SIG_IGN);
+
+    while (!stopRequested) {
+        int connection = accept(listener, NULL, NULL);
+        if (connection < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            cerr << "ERROR: cannot accept a connection: " << strerror(errno) << "." << endl;
+            break;
+        }
+        // the connections that are still served end with the process
+        thread(serveConnection, connection, serve).detach();
+    }
+    close(listener);
+    unlink(path.c_str());
+    return 0;
+}
+
+SharedRegion::SharedRegion() :
+        mData(NULL), mSize(0) {
+}
+
+SharedRegion::~SharedRegion() {
+    if (mData != NULL) {
+        munmap(mData, mSize);
+    }
+}
+
+bool SharedRegion::map(const string& path) {
+    int fd = open(path.c_str(), O_RDWR);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0 || info.st_size == 0) {
+        cerr << "ERROR: cannot open shared memory " << path << "." << endl;
+        if (fd >= 0) {
+            close(fd);
+        }
+        return false;
+    }
+    void* data = mmap(NULL, info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    // the mapping stays valid without the descriptor
+    close(fd);
+    if (data == MAP_FAILED) {
+        cerr << "ERROR: cannot map shared memory " << path << ": " << strerror(errno) << "."
+                << endl;
+        return false;
+    }
+    mData = (char*) data;
+    mSize = info.st_size;
+    return true;
+}
+
+#endif
+
+FdOutputBuffer::FdOutputBuffer(int fd) :
+        mFd(fd), mBuffer(OUTPUT_BUFFER_SIZE) {
+    setp(&mBuffer[0], &mBuffer[0] + mBuffer.size());
+}
+
+FdOutputBuffer::~FdOutputBuffer() {
+    drain();
+}
+
+bool FdOutputBuffer::drain() {
+    const char* data = pbase();
+    size_t count = pptr() - pbase();
+    while (count > 0) {
+#ifdef _WIN32
+        int written = _write(mFd, data, (unsigned int) count);
+#else
+        ssize_t written = write(mFd, data, count);
+#endif
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            // the client is gone; the rest of its responses is dropped
+            setp(&mBuffer[0], &mBuffer[0] + mBuffer.size());
+            return false;
+        }
+        data += written;
+        count -= written;
+    }
+    setp(&mBuffer[0], &mBuffer[0] + mBuffer.size());
+    return true;
+}
+
+FdOutputBuffer::int_type FdOutputBuffer::overflow(int_type c) {
+    if (!drain()) {
+        return traits_type::eof();
+    }
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+    }
+    return traits_type::not_eof(c);
+}
+
+int FdOutputBuffer::sync() {
+    return drain() ? 0 : -1;
+}
+
+streamsize FdOutputBuffer::xsputn(const char* data, streamsize count) {
+    streamsize done = 0;
+    while (done < count) {
+        streamsize space = epptr() - pptr();
+        if (space == 0) {
+            if (!drain()) {
+                return done;
+            }
+            continue;
+        }
+        streamsize chunk = min(space, count - done);
+        memcpy(pptr(), data + done, chunk);
+        pbump((int) chunk);
+        done += chunk;
+    }
+    return done;
+}
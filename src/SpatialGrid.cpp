@@ -0,0 +1,129 @@
+/**
+ * @file    SpatialGrid.cpp
+ * @author  libavoid-server contributors
+ *
+ * @section LICENSE
+ *
+ * Copyright (c) 2026 Kiel University and others.
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the Eclipse Public License 2.0 which is available at
+ * http://www.eclipse.org/legal/epl-2.0.
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *
+ * @section DESCRIPTION
+ *
+ * The implementation of the spatial grid defined in SpatialGrid.h.
+ */
+#include "SpatialGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace std;
+
+/** The grid has at most this many cells per box. */
+static const double CELLS_PER_BOX = 4;
+
+void Box::include(const Box& other) {
+    x1 = min(x1, other.x1);
+    y1 = min(y1, other.y1);
+    x2 = max(x2, other.x2);
+    y2 = max(y2, other.y2);
+}
+
+SpatialGrid::SpatialGrid() :
+        mX(0), mY(0), mCellSize(1), mCols(0), mRows(0) {
+}
+
+void SpatialGrid::build(const vector<Box>& boxes) {
+    mBoxes = boxes;
+    mOffsets.clear();
+    mEntries.clear();
+    mCols = 0;
+    mRows = 0;
+    if (boxes.empty()) {
+        return;
+    }
+
+    Box bounds = boxes[0];
+    double sizes = 0;
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        bounds.include(boxes[i]);
+        sizes += max(boxes[i].x2 - boxes[i].x1, boxes[i].y2 - boxes[i].y1);
+    }
+    double width = bounds.x2 - bounds.x1;
+    double height = bounds.y2 - bounds.y1;
+
+    // cells of twice the average size, unless there would be too many of them
+    mCellSize = max(2 * sizes / boxes.size(), 1.0);
+    double cells = (width / mCellSize + 1) * (height / mCellSize + 1);
+    double maxCells = CELLS_PER_BOX * boxes.size();
+    if (cells > maxCells) {
+        mCellSize *= sqrt(cells / maxCells);
+    }
+    mX = bounds.x1;
+    mY = bounds.y1;
+    mCols = (size_t) (width / mCellSize) + 1;
+    mRows = (size_t) (height / mCellSize) + 1;
+
+    // count the entries of each cell, then fill them in
+    mOffsets.assign(mCols * mRows + 1, 0);
+    size_t col1, row1, col2, row2;
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        cellRange(boxes[i], col1, row1, col2, row2);
+        for (size_t row = row1; row <= row2; ++row) {
+            for (size_t col = col1; col <= col2; ++col) {
+                ++mOffsets[row * mCols + col + 1];
+            }
+        }
+    }
+    for (size_t i = 1; i < mOffsets.size(); ++i) {
+        mOffsets[i] += mOffsets[i - 1];
+    }
+    mEntries.resize(mOffsets.back());
+    vector<size_t> next(mOffsets.begin(), mOffsets.end() - 1);
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        cellRange(boxes[i], col1, row1, col2, row2);
+        for (size_t row = row1; row <= row2; ++row) {
+            for (size_t col = col1; col <= col2; ++col) {
+                mEntries[next[row * mCols + col]++] = i;
+            }
+        }
+    }
+}
+
+void SpatialGrid::cellRange(const Box& box, size_t& col1, size_t& row1, size_t& col2,
+        size_t& row2) const {
+    // the coordinates are clamped before the conversion, which would overflow otherwise
+    double maxCol = (double) (mCols - 1);
+    double maxRow = (double) (mRows - 1);
+    col1 = (size_t) min(max(floor((box.x1 - mX) / mCellSize), 0.0), maxCol);
+    row1 = (size_t) min(max(floor((box.y1 - mY) / mCellSize), 0.0), maxRow);
+    col2 = (size_t) min(max(floor((box.x2 - mX) / mCellSize), 0.0), maxCol);
+    row2 = (size_t) min(max(floor((box.y2 - mY) / mCellSize), 0.0), maxRow);
+}
+
+void SpatialGrid::query(const Box& area, vector<size_t>& result) const {
+    if (mCols == 0) {
+        return;
+    }
+    size_t first = result.size();
+    size_t col1, row1, col2, row2;
+    cellRange(area, col1, row1, col2, row2);
+    for (size_t row = row1; row <= row2; ++row) {
+        for (size_t col = col1; col <= col2; ++col) {
+            size_t cell = row * mCols + col;
+            for (size_t i = mOffsets[cell]; i < mOffsets[cell + 1]; ++i) {
+                if (mBoxes[mEntries[i]].overlaps(area)) {
+                    result.push_back(mEntries[i]);
+                }
+            }
+        }
+    }
+    // a box that covers several cells is found once per cell
+    sort(result.begin() + first, result.end());
+    result.erase(unique(result.begin() + first, result.end()), result.end());
+}
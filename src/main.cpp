@@ -21,17 +21,62 @@
 #include <sstream>
 #include <algorithm>
 #include <iterator>
+#include <utility>
 #include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <cerrno>
+#include <fstream>
+#include <atomic>
+#include <thread>
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#endif
 
 #include "ChunkStream.h"
 #include "libavoid/libavoid.h"
 #include "LibavoidRouting.h"
+#include "RouterSession.h"
+#include "RoutingRequest.h"
+#include "RequestPool.h"
+#include "BinaryProtocol.h"
+#include "ResultCache.h"
+#include "RoutingControl.h"
+#include "Prefork.h"
+#include "SocketServer.h"
+#include "RequestTrace.h"
 
 using namespace std;
 
 /* The keyword used to separate parts of the data transmission. */
 #define CHUNK_KEYWORD "[CHUNK]\n"
 
+/* The result cache; null if it is not enabled. */
+static ResultCache* resultCache = NULL;
+
+/* The pool of concurrent request handling; null without --threads. */
+static RequestPool* requestPool = NULL;
+
+/* The number of workers of the request pool; 0 to handle requests in turn. */
+static unsigned int poolThreads = 0;
+
+/* The largest number of workers of the request pool. */
+const unsigned long MAX_POOL_THREADS = 1024;
+
+/* The largest number of pending bytes given to --flush-size. */
+const unsigned long MAX_FLUSH_SIZE = 1UL << 30;
+
+/* The largest cache size in MiB given to --cache-size. */
+const unsigned long MAX_CACHE_SIZE = 1UL << 20;
+
+/* The largest number of worker processes in prefork mode. */
+const unsigned long MAX_PREFORK_WORKERS = 256;
+
+/* The trace requests are recorded to; null if they are not recorded. */
+static TraceWriter* traceWriter = NULL;
+
 /**
  * Handles a layout request, which consists of reading the graph and layout
  * options from the input stream, performing the actual connector routing
@@ -41,225 +86,968 @@ using namespace std;
  *            the input stream
  * @param out
  *            the output stream
+ * @param sessions
+ *            the named sessions kept alive between requests
  */
-void HandleRequest(chunk_istream& stream, ostream& out);
+void HandleRequest(LineSource& in, ostream& out, SessionMap& sessions);
 
 /**
- * The program entry point.
+ * Handles a chunk of the text protocol, which is either a single request or a
+ * batch of them.
+ *
+ * @param in
+ *            the lines of the chunk
+ * @param out
+ *            the output stream
+ * @param sessions
+ *            the named sessions kept alive between requests
  */
-int main(void) {
+void HandleChunk(LineSource& in, ostream& out, SessionMap& sessions);
 
-    // handle requests from stdin, writes to stdout
-    chunk_istream chunkStream(cin, CHUNK_KEYWORD);
-    while (!chunkStream.isRealEof()) {
-        HandleRequest(chunkStream, cout);
-        chunkStream.nextChunk();
+/**
+ * Handles a batch of requests, each ending with its GRAPHEND line. They are
+ * routed concurrently and answered together, in the order of the batch.
+ *
+ * @param announced
+ *            the number of requests announced by the BATCH line
+ * @param in
+ *            the lines of the chunk behind the BATCH line
+ * @param out
+ *            the output stream
+ */
+void HandleBatch(size_t announced, LineSource& in, ostream& out);
+
+/**
+ * Handles a layout request of the binary protocol.
+ *
+ * @param in
+ *            the source of the request's frames
+ * @param out
+ *            the output stream the LAYOUT frame is written to
+ * @param sessions
+ *            the named sessions kept alive between requests
+ * @return false if the end of input is reached
+ */
+bool HandleBinaryRequest(ByteSource& in, ostream& out, SessionMap& sessions);
+
+/**
+ * Cancels the requests with the given id, or all of them if the id is empty.
+ * Requests of the pool are known before they are parsed.
+ *
+ * @return the number of requests cancelled
+ */
+unsigned int CancelRequests(const string& id);
+
+/**
+ * Handles a chunk that only consists of CANCEL lines right away, so that it
+ * does not wait for a free worker.
+ *
+ * @param request
+ *            the complete text of the chunk
+ * @return false if the chunk is a request to be routed
+ */
+bool HandleControl(const string& request);
+
+/**
+ * Handles requests whose text and routes are exchanged through shared memory.
+ *
+ * @param tokens
+ *            the SHARED line of the request
+ * @param region
+ *            the shared memory of the connection
+ * @param out
+ *            the output stream the answer is written to
+ * @param sessions
+ *            the named sessions kept alive between requests
+ */
+void HandleSharedRequest(const LineParser& tokens, SharedRegion& region, ostream& out,
+        SessionMap& sessions);
+
+/**
+ * Handles all requests of a connection, e.g. the standard input and output.
+ *
+ * @param in
+ *            the file descriptor requests are read from
+ * @param out
+ *            the output stream responses are written to
+ * @return the exit code
+ */
+int ServeConnection(int in, ostream& out);
+
+/**
+ * Serves a connection to the socket.
+ *
+ * @return the exit code
+ */
+int ServeSocket(int fd);
+
+/**
+ * Defines the profiles of a file, which is read like a request that is not
+ * routed.
+ *
+ * @return false if the file cannot be read
+ */
+bool LoadProfiles(const string& path);
+
+/**
+ * Hands out the lines of the current chunk of a chunk stream.
+ */
+class ChunkLineSource: public LineSource {
+public:
+    explicit ChunkLineSource(chunk_istream& stream) :
+        mStream(stream), mLine(NULL), mLength(0), mPushedBack(false) {
     }
 
-    return 0;
-}
+    virtual bool nextLine(char*& line, size_t& length) {
+        if (mPushedBack) {
+            mPushedBack = false;
+            line = mLine;
+            length = mLength;
+            return true;
+        }
+        if (!mStream.nextLine(line, length)) {
+            return false;
+        }
+        mLine = line;
+        mLength = length;
+        return true;
+    }
+
+    /** Hands out the last line once more; it must not have been modified. */
+    void pushBack() {
+        mPushedBack = true;
+    }
+
+private:
+    chunk_istream& mStream;
+    char* mLine;
+    size_t mLength;
+    bool mPushedBack;
+};
+
+/**
+ * Reads the raw bytes of a chunk stream.
+ */
+class ChunkByteSource: public ByteSource {
+public:
+    explicit ChunkByteSource(chunk_istream& stream) :
+        mStream(stream) {
+    }
 
-void HandleRequest(chunk_istream& stream, ostream& out) {
+    virtual bool read(char* data, size_t count) {
+        return mStream.readBlock(data, count);
+    }
 
-    vector<Avoid::ShapeRef *> shapes;
-    vector<Avoid::ShapeConnectionPin *> pins;
-    vector<Avoid::ConnRef *> cons;
+private:
+    chunk_istream& mStream;
+};
 
-	// router is initialized upon receiption of the edge routing option
-    Avoid::Router *router = 0;
+/**
+ * @return the rest of the line if it starts with the keyword, apart from
+ *         leading blanks; null otherwise
+ */
+static const char* matchKeyword(const char* line, const char* keyword) {
+    while (*line == ' ' || *line == '\t') {
+        ++line;
+    }
+    size_t length = strlen(keyword);
+    if (strncmp(line, keyword, length) != 0) {
+        return NULL;
+    }
+    line += length;
+    return *line == '\0' || isspace((unsigned char) *line) ? line : NULL;
+}
 
-    // options
-    Avoid::ConnType connectorType = Avoid::ConnType_Orthogonal;
-    std::string direction = DIRECTION_UNDEFINED;
+/**
+ * Hands out a line taken from another source before the rest of its lines.
+ */
+class ResumedLineSource: public LineSource {
+public:
+    ResumedLineSource(LineSource& source, char* line, size_t length) :
+        mSource(source), mLine(line), mLength(length), mPending(true) {
+    }
 
-	// should we print debug information?
-	bool debug = false;
-    // has the graph declaration started?
-    bool graphDecl = false;
-    // have hyperedges been enabled? will result in decreased performance
-    bool hyperedges = false;
+    virtual bool nextLine(char*& line, size_t& length) {
+        if (mPending) {
+            mPending = false;
+            line = mLine;
+            length = mLength;
+            return true;
+        }
+        return mSource.nextLine(line, length);
+    }
 
-    // read graph from stdin
-    for (std::string line; std::getline(std::cin, line);) {
+private:
+    LineSource& mSource;
+    char* mLine;
+    size_t mLength;
+    bool mPending;
+};
 
-        // split the line into its parts
-        vector<string> tokens;
-        tokenize(line, tokens);
+/**
+ * Parses the decimal number given to a program argument.
+ *
+ * @return false if the text is no number or exceeds the maximum
+ */
+static bool parseCount(const char* text, unsigned long maximum, unsigned long& count) {
+    // strtoul would wrap negative numbers around
+    char* end;
+    errno = 0;
+    count = strtoul(text, &end, 10);
+    return isdigit((unsigned char) *text) && *end == '\0' && errno == 0 && count <= maximum;
+}
 
-        if (tokens.size() >= 3 && tokens[0] == "PENALTY") {
-            if (router == NULL) {
-                router = new Avoid::Router(Avoid::OrthogonalRouting);
+/**
+ * The program entry point.
+ *
+ * Usage: libavoid-server [--threads {n}] [--flush-size {bytes}] [--cache-size {MiB}]
+ *            [--cache-dir {path}] [--control {path}] [--profiles {path}]
+ *            [--socket {path} [--prefork {n}]] [--record {path}]
+ *
+ * With --threads, requests are handled concurrently by n workers and each
+ * response is preceded by a line RESPONSE {request id}.
+ *
+ * With --flush-size, a response is written as soon as the given number of
+ * bytes is formatted instead of once it is complete; 0 disables it.
+ *
+ * With --cache-size {MiB} and/or --cache-dir {path}, responses are cached and
+ * repeated requests are answered without routing.
+ *
+ * With --control, CANCEL [request id] lines are read from the given file,
+ * usually a named pipe, while requests are handled. With --threads, a chunk of
+ * CANCEL lines has the same effect.
+ *
+ * With --profiles, the PROFILE define lines of the given file are read before
+ * any request.
+ *
+ * With --socket, the connections to the given Unix domain socket are served
+ * instead of the standard input, each by a thread of its own. With --prefork,
+ * they are served by the given number of worker processes instead.
+ *
+ * With --record, the requests of the text protocol are appended to the given
+ * trace together with the times of their phases and the hash of their routes.
+ *
+ * If the first line of the input is a PROTOCOL handshake, it is answered with
+ * the protocol used for the rest of the input. The binary and the shared
+ * memory protocol are not available together with --threads.
+ */
+int main(int argc, char* argv[]) {
+
+    size_t cacheSize = 0;
+    string cacheDir;
+    string controlPath;
+    string profilesPath;
+    unsigned int prefork = 0;
+    string socketPath;
+    string tracePath;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            const char* count = argv[++i];
+            unsigned long threads;
+            if (!parseCount(count, MAX_POOL_THREADS, threads)) {
+                cerr << "ERROR: invalid number of threads " << count << "; at most "
+                        << MAX_POOL_THREADS << " are supported." << endl;
+                return 1;
             }
-            if (graphDecl) {
-                cerr << "WARNING: penalties should not be specified after GRAPH declaration" << endl;
+            poolThreads = (unsigned int) threads;
+        } else if (strcmp(argv[i], "--flush-size") == 0 && i + 1 < argc) {
+            const char* size = argv[++i];
+            unsigned long bytes;
+            if (!parseCount(size, MAX_FLUSH_SIZE, bytes)) {
+                cerr << "ERROR: invalid flush size " << size << "; at most " << MAX_FLUSH_SIZE
+                        << " bytes are supported." << endl;
+                return 1;
             }
-
-            /* Penalties */
-            setPenalty(tokens[1], tokens[2], router);
-
-        } else if (tokens.size() >= 3 && tokens[0] == "ROUTINGOPTION") {
-            if (router == NULL) {
-                router = new Avoid::Router(Avoid::OrthogonalRouting);
+            setLayoutHighWaterMark(bytes);
+        } else if (strcmp(argv[i], "--cache-size") == 0 && i + 1 < argc) {
+            const char* size = argv[++i];
+            unsigned long mebibytes;
+            if (!parseCount(size, MAX_CACHE_SIZE, mebibytes)) {
+                cerr << "ERROR: invalid cache size " << size << "; at most " << MAX_CACHE_SIZE
+                        << " MiB are supported." << endl;
+                return 1;
             }
-            if (graphDecl) {
-                cerr << "WARNING: routing options should not be specified after GRAPH declaration" << endl;
+            cacheSize = mebibytes;
+        } else if (strcmp(argv[i], "--cache-dir") == 0 && i + 1 < argc) {
+            cacheDir = argv[++i];
+        } else if (strcmp(argv[i], "--control") == 0 && i + 1 < argc) {
+            controlPath = argv[++i];
+        } else if (strcmp(argv[i], "--profiles") == 0 && i + 1 < argc) {
+            profilesPath = argv[++i];
+        } else if (strcmp(argv[i], "--prefork") == 0 && i + 1 < argc) {
+            const char* count = argv[++i];
+            unsigned long workers;
+            if (!parseCount(count, MAX_PREFORK_WORKERS, workers)) {
+                cerr << "ERROR: invalid number of worker processes " << count << "; at most "
+                        << MAX_PREFORK_WORKERS << " are supported." << endl;
+                return 1;
             }
+            prefork = (unsigned int) workers;
+        } else if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            socketPath = argv[++i];
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else {
+            cerr << "ERROR: invalid argument " << argv[i] << "." << endl;
+            return 1;
+        }
+    }
+    if (prefork > 0 && (socketPath.empty() || !controlPath.empty())) {
+        cerr << "ERROR: --prefork requires --socket and excludes --control." << endl;
+        return 1;
+    }
+    if (prefork > 0 && !tracePath.empty()) {
+        // the workers would write to the same file
+        cerr << "ERROR: --record is not available with --prefork." << endl;
+        return 1;
+    }
+    if (prefork == 0 && !socketPath.empty() && poolThreads > 0) {
+        // the connections are served concurrently already
+        cerr << "ERROR: --socket excludes --threads unless --prefork is given." << endl;
+        return 1;
+    }
 
-            /* Routing options */
-            setOption(tokens[1], tokens[2], router);
+    if (cacheSize > 0 || !cacheDir.empty()) {
+        // 64 MiB by default if only the directory is given
+        resultCache = new ResultCache((cacheSize > 0 ? cacheSize : 64) << 20, cacheDir);
+    }
+    if (!profilesPath.empty() && !LoadProfiles(profilesPath)) {
+        return 1;
+    }
+    if (!tracePath.empty()) {
+        traceWriter = new TraceWriter();
+        if (!traceWriter->open(tracePath)) {
+            return 1;
+        }
+    }
 
-        } else if (tokens.size() >= 3 && tokens[0] == "OPTION") {
-            if (graphDecl) {
-                cerr << "WARNING: options should not be specified after GRAPH declaration" << endl;
-            }
-            std::string optionId = tokens[1];
-            if (optionId.rfind("org.eclipse.elk.", 0) == 0) {
-                optionId = optionId.substr(16, std::string::npos);
-            } else if (optionId.rfind("de.cau.cs.kieler.", 0) == 0) {
-                optionId = optionId.substr(17, std::string::npos);
-            }
+    // the workers inherit everything set up so far
+    if (prefork > 0) {
+        return runPrefork(socketPath, prefork, ServeSocket);
+    }
+    if (!controlPath.empty()) {
+        startControlChannel(controlPath, CancelRequests);
+    }
+    int exitCode;
+    if (!socketPath.empty()) {
+        exitCode = runSocketServer(socketPath, ServeSocket);
+    } else {
+#ifdef _WIN32
+        // binary frames must not be subject to line break translation
+        _setmode(_fileno(stdin), _O_BINARY);
+#endif
+        // handle requests from stdin, writes to stdout
+        exitCode = ServeConnection(0, cout);
+    }
+    // completes the compressed trace
+    delete traceWriter;
+    return exitCode;
+}
 
-            /* General options */
-            if (optionId == EDGE_ROUTING) {
-				if (router) {
-					// possibly delete an old router
-                    cerr << "WARNING: discarding previous options due to " << EDGE_ROUTING << " declaration." << endl;
-					delete router;
-				}
-                // edge routing
-                if (tokens[2] == EDGE_ROUTING_POLYLINE) {
-					router = new Avoid::Router(Avoid::PolyLineRouting);
-                    connectorType = Avoid::ConnType_PolyLine;
-                } else {
-                    // default orthogonal
-					router = new Avoid::Router(Avoid::OrthogonalRouting);
-                    connectorType = Avoid::ConnType_Orthogonal;
+int ServeSocket(int fd) {
+    FdOutputBuffer buffer(fd);
+    ostream out(&buffer);
+    int exitCode = ServeConnection(fd, out);
+    out.flush();
+    return exitCode;
+}
+
+int ServeConnection(int in, ostream& out) {
+
+    chunk_istream chunkStream(in, CHUNK_KEYWORD);
+    ChunkLineSource lines(chunkStream);
+
+    // the optional handshake selects the protocol
+    bool binary = false;
+    SharedRegion region;
+    bool shared = false;
+    char* first;
+    size_t firstLength;
+    if (lines.nextLine(first, firstLength)) {
+        if (strncmp(first, "PROTOCOL ", 9) == 0) {
+            // other versions of the binary protocol are answered with the text protocol
+            binary = matchKeyword(first, PROTOCOL_BINARY) != NULL && poolThreads == 0;
+            // format: PROTOCOL SHARED path
+            shared = strncmp(first + 9, "SHARED ", 7) == 0 && poolThreads == 0
+                    && region.map(first + 16);
+            out << (binary ? PROTOCOL_BINARY : shared ? PROTOCOL_SHARED : PROTOCOL_TEXT) << endl;
+        } else {
+            lines.pushBack();
+        }
+    }
+
+    if (binary) {
+#ifdef _WIN32
+        if (in == 0) {
+            out.flush();
+            _setmode(_fileno(stdout), _O_BINARY);
+        }
+#endif
+        SessionMap sessions;
+        ChunkByteSource bytes(chunkStream);
+        while (HandleBinaryRequest(bytes, out, sessions)) {
+        }
+        for (SessionMap::iterator it = sessions.begin(); it != sessions.end(); ++it) {
+            delete it->second;
+        }
+        return 0;
+    }
+
+    if (shared) {
+        SessionMap sessions;
+        LineParser tokens;
+        char* line;
+        size_t length;
+        while (!chunkStream.isRealEof()) {
+            while (lines.nextLine(line, length)) {
+                if (tokens.parse(line, length) > 0) {
+                    HandleSharedRequest(tokens, region, out, sessions);
                 }
-            } else if (optionId == DIRECTION) {
-                // layout direction
-                direction = tokens[2];
-            } else if (optionId == ENABLE_HYPEREDGES_FROM_COMMON_SOURCE) {
-                hyperedges = toBool(tokens[2]);
-            } else {
-                cerr << "ERROR: unknown option " << tokens[1] << "." << endl;
             }
+            chunkStream.nextChunk();
+        }
+        for (SessionMap::iterator it = sessions.begin(); it != sessions.end(); ++it) {
+            delete it->second;
+        }
+        return 0;
+    }
 
-        } else if (tokens[0] == "NODE") {
-            if (router == NULL) {
-                router = new Avoid::Router(Avoid::OrthogonalRouting);
-            }
-            if (!graphDecl) {
-                cerr << "ERROR: missing declaration of GRAPH" << endl;
-                graphDecl = true;
+    if (poolThreads > 0) {
+        // the pool's destructor waits for all pending requests
+        RequestPool pool(HandleChunk, poolThreads, out);
+        requestPool = &pool;
+        string request;
+        char* line;
+        size_t length;
+        while (!chunkStream.isRealEof()) {
+            request.clear();
+            while (lines.nextLine(line, length)) {
+                request.append(line, length);
+                request += '\n';
             }
-            // format:
-            // id topleft bottomright portLessIncomingEdges portLessOutgoingEdges
-            if (tokens.size() != 8) {
-                cerr << "ERROR: invalid node format" << endl;
+            if (request.find_first_not_of(" \t\r\n") != string::npos && !HandleControl(request)) {
+                pool.submit(move(request));
             }
+            chunkStream.nextChunk();
+        }
+        requestPool = NULL;
+        return 0;
+    }
 
-            addNode(tokens, shapes, router, direction);
+    SessionMap sessions;
+    while (!chunkStream.isRealEof()) {
+        HandleChunk(lines, out, sessions);
+        chunkStream.nextChunk();
+    }
 
-        } else if (tokens[0] == "CLUSTER") {
-            if (router == NULL) {
-                router = new Avoid::Router(Avoid::OrthogonalRouting);
-            }
-            if (!graphDecl) {
-                cerr << "ERROR: missing declaration of GRAPH" << endl;
-                graphDecl = true;
-            }
-            // format:
-            // id topleft bottomright
-            if (tokens.size() != 6) {
-                cerr << "ERROR: invalid cluster format" << endl;
-            }
+    for (SessionMap::iterator it = sessions.begin(); it != sessions.end(); ++it) {
+        delete it->second;
+    }
 
-            addCluster(tokens, shapes, router);
+    return 0;
+}
 
-        } else if (tokens[0] == "PORT") {
-            if (router == NULL) {
-                router = new Avoid::Router(Avoid::OrthogonalRouting);
-            }
-            if (!graphDecl) {
-                cerr << "ERROR: missing declaration of GRAPH" << endl;
-                graphDecl = true;
-            }
-            // format: portId nodeId portSide centerX centerYs
-            if (tokens.size() != 6) {
-                cerr << "ERROR: invalid port format" << endl;
-            }
+bool LoadProfiles(const string& path) {
+    ifstream file(path.c_str());
+    if (!file) {
+        cerr << "ERROR: cannot read profiles " << path << "." << endl;
+        return false;
+    }
+    string text((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    StringLineSource lines(text);
+    SessionMap sessions;
+    RoutingRequest request(sessions);
+    LineParser tokens;
+    char* line;
+    size_t length;
+    while (lines.nextLine(line, length)) {
+        tokens.parse(line, length);
+        request.handleLine(tokens);
+    }
+    return true;
+}
 
-            addPort(tokens, pins, shapes, router);
+/**
+ * Writes the routes of a request that has been routed.
+ *
+ * @return false if the routing has been aborted
+ */
+static bool WriteLayout(RoutingRequest& request, ostream& out) {
+    vector<Avoid::ConnRef*> cons;
+    request.result(cons);
+    vector<Hyperedge> hyperedges;
+    request.hyperedges(hyperedges);
+    RouteReport report;
+    bool withStates = request.report(cons, report);
+    RequestStats& stats = request.stats();
+    PhaseTimer timer(stats, PHASE_OUTPUT);
+    stats.bytesOut += writeLayout(out, cons, withStates ? &report : NULL, &hyperedges,
+            request.precision());
+    return report.complete();
+}
 
-        } else if (tokens[0] == "EDGE" || tokens[0] == "PEDGEP" || tokens[0] == "PEDGE"
-                || tokens[0] == "EDGEP") {
-            if (router == NULL) {
-                router = new Avoid::Router(Avoid::OrthogonalRouting);
-            }
-            if (!graphDecl) {
-                cerr << "ERROR: missing declaration of GRAPH" << endl;
-                graphDecl = true;
-            }
-            // format: edgeId srcId tgtId srcPort tgtPort
-            if (tokens.size() != 6) {
-                cerr << "ERROR: invalid edge format" << endl;
-            }
+/**
+ * Reads the graph of a request, performs the routing and writes the layout.
+ *
+ * @param record
+ *            the trace record that takes the times of the phases; null if the
+ *            request is not recorded
+ * @return false if the routing has been aborted
+ */
+static bool RouteRequest(LineSource& in, ostream& out, SessionMap& sessions,
+        TraceRecord* record = NULL) {
 
-            addEdge(tokens, connectorType, shapes, cons, router, direction);
+    RoutingRequest request(sessions);
 
-		} else if (tokens[0] == "DEBUG") {
-			debug = true;
+    // the token buffer is reused for all lines, which are parsed in place
+    char* line;
+    size_t length;
+    LineParser tokens;
 
-        } else if (tokens[0] == "GRAPH") {
-            if (graphDecl) {
-                cerr << "ERROR: duplicate declaration of GRAPH" << endl;
-            }
-            graphDecl = true;
-        } else if (tokens[0] == "GRAPHEND") {
-            if (!graphDecl) {
-                cerr << "ERROR: missing declaration of GRAPH" << endl;
-            }
+    RequestStats& stats = request.stats();
+    if (record != NULL) {
+        stats.startTiming();
+    }
+
+    // read graph from the request's input stream
+    while (in.nextLine(line, length)) {
+        stats.bytesIn += length + 1;
+        {
+            PhaseTimer timer(stats, PHASE_PARSE);
+            tokens.parse(line, length);
+        }
+        if (!request.handleLine(tokens)) {
             break;
-        } else if (tokens[0] == "#") {
-            // ignore it
-        } else {
-            cerr << "ERROR: invalid command " << tokens[0] << "." << endl;
         }
     }
-    if (router == NULL) {
+
+    if (request.routeCoarse()) {
+        // a first layout for the client to show while the final one is routed
+        WriteLayout(request, out);
+        publishResponse(out);
+    }
+    bool complete = true;
+    if (request.route()) {
+        // write the layout to std out
+        complete = WriteLayout(request, out);
+    }
+    reportStats(out, stats);
+    if (record != NULL) {
+        recordStats(stats, *record);
+    }
+
+    // cleanup of the request's own graph is done by the session's destructor
+    return complete;
+}
+
+/**
+ * Routes a request given as its complete text, which is modified, and
+ * records it if requests are recorded.
+ *
+ * @return false if the routing has been aborted
+ */
+static bool RouteText(string& text, ostream& out, SessionMap& sessions) {
+    if (traceWriter == NULL || text.find_first_not_of(" \t\r\n") == string::npos) {
+        StringLineSource lines(text);
+        return RouteRequest(lines, out, sessions);
+    }
+
+    TraceRecord record;
+    record.request = text;
+    StringLineSource lines(text);
+    // the response is hashed before it is written, so it is written once complete
+    ostringstream routed;
+    bool complete = RouteRequest(lines, routed, sessions, &record);
+    string response = routed.str();
+    out.write(response.data(), response.size());
+    out.flush();
+    record.hash = hashResponse(response);
+    traceWriter->write(record);
+    return complete;
+}
+
+unsigned int CancelRequests(const string& id) {
+    return requestPool != NULL ? requestPool->cancel(id) : cancelRequests(id);
+}
+
+bool HandleControl(const string& request) {
+    istringstream in(request);
+    LineParser tokens;
+    vector<string> ids;
+    for (string line; getline(in, line);) {
+        tokens.parse(line);
+        if (tokens.empty() || tokens.command() == CMD_COMMENT) {
+            continue;
+        }
+        if (tokens.command() != CMD_CANCEL) {
+            return false;
+        }
+        ids.push_back(tokens.size() >= 2 ? tokens[1] : "");
+    }
+    for (size_t i = 0; i < ids.size(); ++i) {
+        if (CancelRequests(ids[i]) == 0) {
+            cerr << "WARNING: no running request to cancel." << endl;
+        }
+    }
+    return true;
+}
+
+void HandleRequest(LineSource& in, ostream& out, SessionMap& sessions) {
+    if (resultCache == NULL && traceWriter == NULL) {
+        RouteRequest(in, out, sessions);
         return;
     }
 
-#ifdef DEBUG_EXEC_TIME
-    // measure execution time of the routing process
-    LARGE_INTEGER frequency;
-    LARGE_INTEGER t1, t2;
-    QueryPerformanceFrequency(&frequency); // ticks per second
-    QueryPerformanceCounter(&t1); // first timestamp
-#endif
+    // the whole request is needed to compute its key or to record it
+    string text;
+    char* line;
+    size_t length;
+    while (in.nextLine(line, length)) {
+        text.append(line, length);
+        text += '\n';
+    }
+    if (resultCache == NULL) {
+        RouteText(text, out, sessions);
+        return;
+    }
+
+    string key;
+    string canonical;
+    switch (ResultCache::canonicalKey(text, key, canonical)) {
+    case CACHE_STATS:
+        resultCache->writeStats(out);
+        break;
 
-    // perform edge routing
-    router->processTransaction();
-    if (hyperedges) {
-        createHyperedges(cons, router);
+    case CACHE_BYPASS:
+        RouteText(text, out, sessions);
+        break;
+
+    case CACHE_USE: {
+        string response;
+        if (!resultCache->lookup(key, canonical, response)) {
+            ostringstream routed;
+            bool complete = RouteText(text, routed, sessions);
+            response = routed.str();
+            // partial results are not worth keeping
+            if (complete && !response.empty()) {
+                resultCache->store(key, canonical, response);
+            }
+        }
+        out.write(response.data(), response.size());
+        out.flush();
+        break;
+    }
     }
+}
 
-#ifdef DEBUG_EXEC_TIME
-    QueryPerformanceCounter(&t2);
-    // compute and print the elapsed time in millisec
-    double elapsedTime = (t2.QuadPart - t1.QuadPart) * 1000.0 / frequency.QuadPart;
-    cout << "DEBUG Execution time edge routing: " << elapsedTime << "ms." << endl;
-#endif
+void HandleChunk(LineSource& in, ostream& out, SessionMap& sessions) {
+    char* line;
+    size_t length;
+    if (!in.nextLine(line, length)) {
+        HandleRequest(in, out, sessions);
+        return;
+    }
+    // the first line is parsed from a copy, the request may still need it
+    string first(line, length);
+    LineParser tokens;
+    if (tokens.parse(first) > 0 && tokens.command() == CMD_BATCH) {
+        HandleBatch(tokens.size() >= 2 ? toId(tokens[1]) : 0, in, out);
+        return;
+    }
+    ResumedLineSource lines(in, line, length);
+    HandleRequest(lines, out, sessions);
+}
 
-	if (debug) {
-		router->outputInstanceToSVG();
-	}
+/** A request of a batch. */
+struct BatchEntry {
+    /** the id given by its REQUEST line, or its number in the batch. */
+    string id;
+    /** the range of its lines in the text of the batch. */
+    size_t begin;
+    size_t end;
+    string response;
+};
 
-    // write the layout to std out
-    writeLayout(cout, cons);
+void HandleBatch(size_t announced, LineSource& in, ostream& out) {
+    // a single pass copies the lines and finds the end of each request; the
+    // requests themselves are parsed by the threads that route them
+    string text;
+    vector<BatchEntry> entries;
+    BatchEntry entry;
+    entry.begin = 0;
+    char* line;
+    size_t length;
+    while (in.nextLine(line, length)) {
+        text.append(line, length);
+        text += '\n';
+        const char* rest = matchKeyword(line, "REQUEST");
+        if (rest != NULL) {
+            istringstream(rest) >> entry.id;
+        } else if (matchKeyword(line, "GRAPHEND") != NULL) {
+            entry.end = text.size();
+            if (entry.id.empty()) {
+                entry.id = to_string(entries.size() + 1);
+            }
+            entries.push_back(entry);
+            entry.id.clear();
+            entry.begin = text.size();
+        }
+    }
+    if (text.find_first_not_of(" \t\r\n", entry.begin) != string::npos) {
+        cerr << "WARNING: ignoring the lines after the last GRAPHEND of a batch." << endl;
+    }
+    if (entries.size() != announced) {
+        cerr << "WARNING: batch of " << announced << " requests contains " << entries.size()
+                << "." << endl;
+    }
 
-    // cleanup
-    delete router;
+    // the threads take the requests in turn and inherit the cancel flag of the batch
+    const atomic<bool>* cancelled = threadCancelFlag();
+    atomic<size_t> next(0);
+    auto work = [&]() {
+        setThreadCancelFlag(cancelled);
+        // sessions do not outlive the batch
+        SessionMap sessions;
+        for (size_t i = next++; i < entries.size(); i = next++) {
+            BufferLineSource lines(&text[entries[i].begin], entries[i].end - entries[i].begin);
+            ostringstream response;
+            HandleRequest(lines, response, sessions);
+            entries[i].response = response.str();
+        }
+        for (SessionMap::iterator it = sessions.begin(); it != sessions.end(); ++it) {
+            delete it->second;
+        }
+    };
+    unsigned int threads = (unsigned int) min<size_t>(max(1u, thread::hardware_concurrency()),
+            entries.size());
+    vector<thread> workers;
+    for (unsigned int i = 1; i < threads; ++i) {
+        workers.push_back(thread(work));
+    }
+    // the calling thread takes part in the work
+    work();
+    for (size_t i = 0; i < workers.size(); ++i) {
+        workers[i].join();
+    }
 
+    // the whole batch is handed to the client at once
+    string response = "BATCH " + to_string(entries.size()) + "\n";
+    for (size_t i = 0; i < entries.size(); ++i) {
+        response += "RESPONSE ";
+        response += entries[i].id;
+        response += '\n';
+        response += entries[i].response;
+    }
+    response += "BATCHEND\n";
+    out.write(response.data(), response.size());
+    out.flush();
 }
 
+void HandleSharedRequest(const LineParser& tokens, SharedRegion& region, ostream& out,
+        SessionMap& sessions) {
+    // format: SHARED offset length resultOffset resultCapacity
+    size_t offset = 0, length = 0, resultOffset = 0, resultCapacity = 0;
+    if (tokens.size() == 5) {
+        offset = toId(tokens[1]);
+        length = toId(tokens[2]);
+        resultOffset = toId(tokens[3]);
+        resultCapacity = toId(tokens[4]);
+    }
+    if (tokens.command() != CMD_SHARED || tokens.size() != 5 || length == 0
+            || !region.contains(offset, length) || !region.contains(resultOffset, resultCapacity)
+            || region.data()[offset + length - 1] != '\n') {
+        cerr << "ERROR: invalid shared request " << tokens[0] << "." << endl;
+        out << "DONE" << endl;
+        return;
+    }
+
+    RoutingRequest request(sessions);
+    RequestStats& stats = request.stats();
+    stats.bytesIn = length;
+
+    // the request is parsed where the client has written it
+    BufferLineSource in(region.data() + offset, length);
+    LineParser requestTokens;
+    char* line;
+    size_t lineLength;
+    while (in.nextLine(line, lineLength)) {
+        {
+            PhaseTimer timer(stats, PHASE_PARSE);
+            requestTokens.parse(line, lineLength);
+        }
+        if (!request.handleLine(requestTokens)) {
+            break;
+        }
+    }
+
+    // a progressive request only gets its final layout
+    vector<Avoid::ConnRef*> cons;
+    vector<Hyperedge> hyperedges;
+    RouteReport report;
+    bool withStates = false;
+    if (request.route()) {
+        request.result(cons);
+        request.hyperedges(hyperedges);
+        withStates = request.report(cons, report);
+    }
+    {
+        // the routes are encoded directly into the client's memory
+        PhaseTimer timer(stats, PHASE_OUTPUT);
+        size_t size = layoutSize(cons, withStates ? &report : NULL);
+        if (size <= resultCapacity) {
+            encodeLayout(region.data() + resultOffset, cons, withStates ? &report : NULL);
+            out << "LAYOUT " << resultOffset << " " << size << "\n";
+            stats.bytesOut += size;
+        } else {
+            out << "OVERFLOW " << size << "\n";
+        }
+        if (withStates) {
+            out << routeStates(cons, report);
+        }
+        out << hyperedgeLines(hyperedges);
+    }
+    reportStats(out, stats);
+    out << "DONE" << endl;
+}
+
+bool HandleBinaryRequest(ByteSource& in, ostream& out, SessionMap& sessions) {
+
+    RoutingRequest request(sessions);
+    RequestStats& stats = request.stats();
+
+    LineParser tokens;
+    NodeRecord node;
+    ClusterRecord cluster;
+    PortRecord port;
+    EdgeRecord edge;
+    unsigned char type;
+    vector<char> payload;
+
+    bool complete = false;
+    while (!complete) {
+        if (!readFrame(in, type, payload)) {
+            // an incomplete request at the end of input is dropped
+            return false;
+        }
+        stats.bytesIn += 5 + payload.size();
+        const char* data = payload.empty() ? NULL : &payload[0];
+        const char* end = data + payload.size();
+
+        switch (type) {
+        case FRAME_TEXT: {
+            // one or more lines of the text protocol
+            payload.push_back('\0');
+            char* line = &payload[0];
+            char* last = line + payload.size() - 1;
+            while (!complete && line < last) {
+                char* lineEnd = find(line, last, '\n');
+                *lineEnd = '\0';
+                {
+                    PhaseTimer timer(stats, PHASE_PARSE);
+                    tokens.parse(line, lineEnd - line);
+                }
+                complete = !request.handleLine(tokens);
+                line = lineEnd + 1;
+            }
+            break;
+        }
+
+        case FRAME_NODE:
+            if (payload.size() % NODE_RECORD_SIZE != 0) {
+                cerr << "ERROR: invalid node frame" << endl;
+                break;
+            }
+            while (data < end) {
+                {
+                    PhaseTimer timer(stats, PHASE_PARSE);
+                    decodeNode(data, node);
+                }
+                request.handleNode(node);
+            }
+            break;
+
+        case FRAME_CLUSTER:
+            if (payload.size() % CLUSTER_RECORD_SIZE != 0) {
+                cerr << "ERROR: invalid cluster frame" << endl;
+                break;
+            }
+            while (data < end) {
+                {
+                    PhaseTimer timer(stats, PHASE_PARSE);
+                    decodeCluster(data, cluster);
+                }
+                request.handleCluster(cluster);
+            }
+            break;
+
+        case FRAME_PORT:
+            if (payload.size() % PORT_RECORD_SIZE != 0) {
+                cerr << "ERROR: invalid port frame" << endl;
+                break;
+            }
+            while (data < end) {
+                bool valid;
+                {
+                    PhaseTimer timer(stats, PHASE_PARSE);
+                    valid = decodePort(data, port);
+                }
+                if (!valid) {
+                    cerr << "ERROR: invalid port format" << endl;
+                } else {
+                    request.handlePort(port);
+                }
+            }
+            break;
+
+        case FRAME_EDGE:
+            if (payload.size() % EDGE_RECORD_SIZE != 0) {
+                cerr << "ERROR: invalid edge frame" << endl;
+                break;
+            }
+            while (data < end) {
+                {
+                    PhaseTimer timer(stats, PHASE_PARSE);
+                    decodeEdge(data, edge);
+                }
+                request.handleEdge(edge);
+            }
+            break;
+
+        default:
+            cerr << "ERROR: invalid frame type " << (int) type << "." << endl;
+            break;
+        }
+    }
+
+    // every request is answered, possibly without any edges
+    if (request.routeCoarse()) {
+        vector<Avoid::ConnRef*> cons;
+        request.result(cons);
+        RouteReport report;
+        bool withStates = request.report(cons, report);
+        PhaseTimer timer(stats, PHASE_OUTPUT);
+        stats.bytesOut += writeLayoutFrame(out, cons, withStates ? &report : NULL);
+    }
+    vector<Avoid::ConnRef*> cons;
+    vector<Hyperedge> hyperedges;
+    RouteReport report;
+    bool withStates = false;
+    if (request.route()) {
+        request.result(cons);
+        request.hyperedges(hyperedges);
+        withStates = request.report(cons, report);
+    }
+    {
+        PhaseTimer timer(stats, PHASE_OUTPUT);
+        stats.bytesOut += writeLayoutFrame(out, cons, withStates ? &report : NULL,
+                &hyperedges);
+    }
+    if (stats.enabled && stats.file.empty()) {
+        ostringstream block;
+        writeStats(block, stats);
+        writeTextFrame(out, block.str());
+    } else {
+        reportStats(out, stats);
+    }
+    return true;
+}